@@ -46,6 +46,7 @@ class Configuration
 	//Direct detection constraints
 	double constraints_mass_min, constraints_mass_max;
 	unsigned int constraints_masses;
+	unsigned int constraints_threads = 1;
 
 	double constraints_certainty;
 
@@ -1,6 +1,7 @@
 #ifndef __DM_Distribution_hpp_
 #define __DM_Distribution_hpp_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,8 +17,13 @@ class DM_Distribution
   protected:
 	std::string name;
 	std::vector<double> v_domain;
-	double Eta_Function_Base(double vMin);
-	void Print_Summary_Base();
+	double Eta_Function_Base(double vMin) const;
+	void Print_Summary_Base() const;
+
+	// Table of the eta function on a uniform vMin grid over the speed domain
+	std::vector<double> eta_table;
+	double eta_table_dv;
+	void Update_Eta_Table();
 
   public:
 	double DM_density;	 //Local DM density
@@ -26,29 +32,47 @@ class DM_Distribution
 	//Constructors:
 	DM_Distribution();
 	DM_Distribution(std::string label, double rhoDM, double vMin, double vMax);
+	virtual ~DM_Distribution() {};
+
+	// Polymorphic copy, e.g. to give each thread its own instance. Derived classes should override this function.
+	virtual DM_Distribution* Clone() const { return new DM_Distribution(*this); };
 
 	double Minimum_DM_Speed() const;
 	double Maximum_DM_Speed() const;
 
 	//Distribution functions
-	virtual double PDF_Velocity(libphysica::Vector vel) { return 0.0; };
-	virtual double PDF_Speed(double v);
-	virtual double CDF_Speed(double v);
-	virtual double PDF_Norm();
-
-	virtual double Differential_DM_Flux(double v, double mDM);
-	virtual double Total_DM_Flux(double mDM);
+	virtual double PDF_Velocity(libphysica::Vector vel) const { return 0.0; };
+	virtual double PDF_Speed(double v) const;
+	virtual double CDF_Speed(double v) const;
+	virtual double PDF_Norm() const;
+	// Batch versions for a list of speeds. By default, they call the single-speed functions. Derived classes which override the single-speed functions
+	// of a class with batch overrides (e.g. Standard_Halo_Model) have to override both overloads, since the batch versions do not call the single-speed ones.
+	virtual std::vector<double> PDF_Speed(const std::vector<double>& vs) const;
+	virtual std::vector<double> CDF_Speed(const std::vector<double>& vs) const;
+
+	virtual double Differential_DM_Flux(double v, double mDM) const;
+	virtual double Total_DM_Flux(double mDM) const;
 
 	//Averages
-	virtual libphysica::Vector Average_Velocity();
-	virtual double Average_Speed(double vMin = -1.0);
+	virtual libphysica::Vector Average_Velocity() const;
+	virtual double Average_Speed(double vMin = -1.0) const;
 
 	//Eta-function for direct detection
-	virtual double Eta_Function(double vMin);
-
-	virtual void Print_Summary(int mpi_rank = 0);
-	void Export_PDF_Speed(std::string file_path, int v_points = 100, bool log_scale = false);
-	void Export_Eta_Function(std::string file_path, int v_points = 100, bool log_scale = false);
+	virtual double Eta_Function(double vMin) const;
+	virtual std::vector<double> Eta_Function(const std::vector<double>& vMins) const;
+
+	// Tabulate the eta function once, e.g. before a scan over DM masses, for an O(1) lookup via Eta_Function_Tabulated().
+	// The table is re-computed when the distribution's parameters are changed via its Set_ functions.
+	void Tabulate_Eta_Function(unsigned int v_points = 1000);
+	void Clear_Eta_Table();
+	bool Eta_Function_Is_Tabulated() const;
+	// Linear interpolation of the table, or Eta_Function(vMin), if the eta function has not been tabulated.
+	double Eta_Function_Tabulated(double vMin) const;
+	std::vector<double> Eta_Function_Tabulated(const std::vector<double>& vMins) const;
+
+	virtual void Print_Summary(int mpi_rank = 0) const;
+	void Export_PDF_Speed(std::string file_path, int v_points = 100, bool log_scale = false) const;
+	void Export_Eta_Function(std::string file_path, int v_points = 100, bool log_scale = false) const;
 };
 
 // 2. Import a tabulated DM distribution from a file (format v[km/sec] :: f(v) [sec/km])
@@ -58,19 +82,58 @@ class Imported_DM_Distribution : public DM_Distribution
 	std::string file_path;
 	libphysica::Interpolation pdf_speed, eta_function;
 
-	void Check_Normalization();
+	void Check_Normalization() const;
 
-	double Eta_Function_Int(double v_min);
+	double Eta_Function_Int(double v_min) const;
 	void Interpolate_Eta();
 
   public:
 	Imported_DM_Distribution(double rho, const std::string& filepath);
 
-	virtual double PDF_Speed(double v) override;
+	virtual Imported_DM_Distribution* Clone() const override { return new Imported_DM_Distribution(*this); };
+
+	using DM_Distribution::Eta_Function;
+	using DM_Distribution::PDF_Speed;
+	virtual double PDF_Speed(double v) const override;
+
+	virtual double Eta_Function(double vMin) const override;
+
+	virtual void Print_Summary(int mpi_rank = 0) const override;
+};
+
+// 3. Tabulated version of any DM distribution
+// The speed pdf is sampled on an adaptively refined grid until linear interpolation reaches the requested relative accuracy,
+// which resolves kinks such as the one at the escape velocity. The cdf and eta function follow from integrating the tabulated pdf.
+class Tabulated_DM_Distribution : public DM_Distribution
+{
+  protected:
+	std::shared_ptr<const DM_Distribution> distribution;
+	double relative_accuracy;
+	std::vector<double> v_grid;
+	libphysica::Interpolation pdf_speed, cdf_speed, eta_function;
+
+	void Refine_Grid(double v_1, double v_2, double pdf_1, double pdf_2, double pdf_tolerance, unsigned int depth, std::vector<double>& pdf_grid);
+	void Tabulate();
+
+  public:
+	// The distribution is copied via Clone(). Distributions of classes without their own Clone() have to be shared instead.
+	explicit Tabulated_DM_Distribution(const DM_Distribution& distr, double rel_accuracy = 1.0e-4);
+	explicit Tabulated_DM_Distribution(std::shared_ptr<const DM_Distribution> distr, double rel_accuracy = 1.0e-4);
+
+	virtual Tabulated_DM_Distribution* Clone() const override { return new Tabulated_DM_Distribution(*this); };
+
+	unsigned int Number_Of_Grid_Points() const;
+
+	using DM_Distribution::CDF_Speed;
+	using DM_Distribution::Eta_Function;
+	using DM_Distribution::PDF_Speed;
+	virtual double PDF_Velocity(libphysica::Vector vel) const override;
+	virtual double PDF_Speed(double v) const override;
+	virtual double CDF_Speed(double v) const override;
 
-	virtual double Eta_Function(double vMin) override;
+	virtual double Eta_Function(double vMin) const override;
 
-	virtual void Print_Summary(int mpi_rank = 0) override;
+	virtual void Print_Summary(int mpi_rank = 0) const override;
 };
 }	// namespace obscura
 
@@ -1,6 +1,11 @@
 #ifndef __DM_Halo_Models_hpp_
 #define __DM_Halo_Models_hpp_
 
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "obscura/DM_Distribution.hpp"
 
 namespace obscura
@@ -17,12 +22,12 @@ class Standard_Halo_Model : public DM_Distribution
 	double N_esc;
 	virtual void Normalize_PDF();
 
-	double PDF_Velocity_SHM(libphysica::Vector vel);
-	double PDF_Speed_SHM(double v);
-	double CDF_Speed_SHM(double v);
-	double Eta_Function_SHM(double vMin);
+	double PDF_Velocity_SHM(libphysica::Vector vel) const;
+	double PDF_Speed_SHM(double v) const;
+	double CDF_Speed_SHM(double v) const;
+	double Eta_Function_SHM(double vMin) const;
 
-	void Print_Summary_SHM();
+	void Print_Summary_SHM() const;
 
   public:
 	//Constructors:
@@ -30,23 +35,30 @@ class Standard_Halo_Model : public DM_Distribution
 	Standard_Halo_Model(double rho, double v0, double vobs, double vesc = 1.0);
 	Standard_Halo_Model(double rho, double v0, libphysica::Vector& vel_obs, double vesc = 1.0);
 
+	virtual Standard_Halo_Model* Clone() const override { return new Standard_Halo_Model(*this); };
+
 	//Set SHM parameters
 	virtual void Set_Speed_Dispersion(double v0);
 	void Set_Escape_Velocity(double vesc);
 	void Set_Observer_Velocity(const libphysica::Vector& vObserver);
 	void Set_Observer_Velocity(int day, int month, int year, int hour = 0, int minute = 0);
 
+	double Get_Speed_Dispersion() const;
+	double Get_Escape_Velocity() const;
 	libphysica::Vector Get_Observer_Velocity() const;
 
 	//Distribution functions
-	virtual double PDF_Velocity(libphysica::Vector vel) override;
-	virtual double PDF_Speed(double v) override;
-	virtual double CDF_Speed(double v) override;
+	virtual double PDF_Velocity(libphysica::Vector vel) const override;
+	virtual double PDF_Speed(double v) const override;
+	virtual double CDF_Speed(double v) const override;
+	virtual std::vector<double> PDF_Speed(const std::vector<double>& vs) const override;
+	virtual std::vector<double> CDF_Speed(const std::vector<double>& vs) const override;
 
 	//Eta-function for direct detection
-	virtual double Eta_Function(double vMin) override;
+	virtual double Eta_Function(double vMin) const override;
+	virtual std::vector<double> Eta_Function(const std::vector<double>& vMins) const override;
 
-	virtual void Print_Summary(int mpi_rank = 0) override;
+	virtual void Print_Summary(int mpi_rank = 0) const override;
 };
 
 // 2. Standard halo model++ (SHM++) as proposed by Evans, O'Hare and McCabe [arXiv:1810.11468]
@@ -62,16 +74,24 @@ class SHM_Plus_Plus : public Standard_Halo_Model
 	double N_esc_S;
 	virtual void Normalize_PDF() override;
 
-	double PDF_Velocity_S(libphysica::Vector vel);
-	double PDF_Speed_S(double v);
-	double CDF_Speed_S(double v);
-	double Eta_Function_S(double vMin);
-
-	// Eta function
-	void Interpolate_Eta_Function_S(int v_points = 100);
-	libphysica::Interpolation eta_interpolation_s;
-
-	void Print_Summary_SHMpp();
+	double PDF_Velocity_S(libphysica::Vector vel) const;
+	double PDF_Speed_S(double v) const;
+	double CDF_Speed_S(double v) const;
+	double Eta_Function_S(double vMin) const;
+
+	// Eta function of the sausage component, interpolated on first use.
+	// The tables are shared by all SHM++ instances with the same (v_0, v_esc, vel_observer, beta), freed with the last one of them, and optionally stored on disk.
+	struct Eta_Table_S
+	{
+		std::array<double, 6> parameters;
+		libphysica::Interpolation interpolation;
+	};
+	mutable std::shared_ptr<const Eta_Table_S> eta_table_s;
+	std::array<double, 6> Eta_Table_S_Parameters() const;
+	libphysica::Interpolation Interpolate_Eta_Function_S(int v_points = 100) const;
+	std::shared_ptr<const Eta_Table_S> Get_Eta_Table_S() const;
+
+	void Print_Summary_SHMpp() const;
 
   public:
 	//Constructors:
@@ -79,22 +99,65 @@ class SHM_Plus_Plus : public Standard_Halo_Model
 	SHM_Plus_Plus(double rho, double v0, double vobs, double vesc, double e = 0.2, double b = 0.9);
 	SHM_Plus_Plus(double rho, double v0, libphysica::Vector& vel_obs, double vesc, double e = 0.2, double b = 0.9);
 
+	virtual SHM_Plus_Plus* Clone() const override { return new SHM_Plus_Plus(*this); };
+
+	friend class Halo_Ensemble;
+
 	//Set SHM++ parameters
 	virtual void Set_Speed_Dispersion(double v0) override;
 
 	void Set_Eta(double e);
 	void Set_Beta(double b);
 
+	// Folder to store and re-use the eta tables of the sausage component across runs. An empty string disables the disk cache.
+	static void Set_Eta_Table_Folder(const std::string& folder);
+
 	//Distribution functions
-	virtual double PDF_Velocity(libphysica::Vector vel) override;
-	virtual double PDF_Speed(double v) override;
-	virtual double CDF_Speed(double v) override;
+	virtual double PDF_Velocity(libphysica::Vector vel) const override;
+	virtual double PDF_Speed(double v) const override;
+	virtual double CDF_Speed(double v) const override;
+	virtual std::vector<double> PDF_Speed(const std::vector<double>& vs) const override;
+	virtual std::vector<double> CDF_Speed(const std::vector<double>& vs) const override;
 
 	//Eta-function for direct detection
-	virtual double Eta_Function(double vMin) override;
+	virtual double Eta_Function(double vMin) const override;
+	virtual std::vector<double> Eta_Function(const std::vector<double>& vMins) const override;
 
-	virtual void Print_Summary(int mpi_rank = 0) override;
+	virtual void Print_Summary(int mpi_rank = 0) const override;
 };
+
+// 3. Ensemble of SHM and SHM++ parameter sets, e.g. for scans over astrophysical uncertainties.
+// The parameters are stored as one array per parameter, so that the eta functions of all members are evaluated together.
+// SHM++ members evaluate (1-eta) * eta_SHM + eta * eta_S with the sausage tables shared with SHM_Plus_Plus. They have to be added via Add_Member(),
+// since the vector constructor copies plain SHMs.
+class Halo_Ensemble
+{
+  private:
+	std::vector<double> DM_densities, v_0s, v_escs, v_observers, N_escs;
+	std::vector<libphysica::Vector> vel_observers;
+
+	// Sausage component (eta = 0 for SHM members)
+	std::vector<double> etas_S, betas_S;
+	std::vector<std::shared_ptr<const SHM_Plus_Plus::Eta_Table_S>> eta_tables_S;
+
+  public:
+	Halo_Ensemble();
+	explicit Halo_Ensemble(const std::vector<Standard_Halo_Model>& SHMs);
+
+	void Add_Member(double rho, double v0, const libphysica::Vector& vel_obs, double vesc);
+	void Add_Member(double rho, double v0, const libphysica::Vector& vel_obs, double vesc, double eta, double beta);
+	void Add_Member(const Standard_Halo_Model& SHM);
+
+	unsigned int Number_Of_Members() const;
+	// A copy of the member, i.e. an SHM_Plus_Plus for SHM++ members.
+	std::shared_ptr<Standard_Halo_Model> Member(unsigned int i) const;
+	double DM_Density(unsigned int i) const;
+	double Maximum_DM_Speed() const;
+
+	// Eta functions of all members, indexed as [vMin][member].
+	std::vector<std::vector<double>> Eta_Functions(const std::vector<double>& vMins) const;
+};
+
 }	// namespace obscura
 
 #endif
\ No newline at end of file
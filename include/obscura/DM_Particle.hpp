@@ -3,6 +3,7 @@
 
 #include <random>
 #include <string>
+#include <vector>
 
 #include "obscura/Target_Atom.hpp"
 #include "obscura/Target_Crystal.hpp"
@@ -39,6 +40,10 @@ class DM_Particle
 	//Constructors:
 	DM_Particle();
 	explicit DM_Particle(double m, double s = 1.0 / 2.0);
+	virtual ~DM_Particle() {};
+
+	// Polymorphic copy, e.g. to give each thread its own instance. Derived classes should override this function.
+	virtual DM_Particle* Clone() const { return new DM_Particle(*this); };
 
 	virtual void Set_Mass(double mDM);
 	void Set_Spin(double s);
@@ -61,12 +66,14 @@ class DM_Particle
 	//Differential cross sections for nuclear targets
 	virtual double dSigma_dq2_Nucleus(double q, const Isotope& target, double vDM, double param = -1.0) const { return 0.0; };
 	double dSigma_dER_Nucleus(double ER, const Isotope& target, double vDM, double param = -1.0) const;
-	double d2Sigma_dER_dEe_Migdal(double ER, double Ee, double vDM, const Isotope& isotope, Atomic_Electron& shell) const;
+	double d2Sigma_dER_dEe_Migdal(double ER, double Ee, double vDM, const Isotope& isotope, const Atomic_Electron& shell) const;
 
 	// Differential cross section for electron targets
 	virtual double dSigma_dq2_Electron(double q, double vDM, double param = -1.0) const { return 0.0; };
-	virtual double d2Sigma_dq2_dEe_Ionization(double q, double Ee, double vDM, Atomic_Electron& shell) const { return 0.0; };
-	virtual double d2Sigma_dq2_dEe_Crystal(double q, double Ee, double vDM, Crystal& crystal) const { return 0.0; };
+	virtual double d2Sigma_dq2_dEe_Ionization(double q, double Ee, double vDM, const Atomic_Electron& shell) const { return 0.0; };
+	// Batched evaluation for all momentum transfers qs at once. Derived classes which override the scalar version should override this one, too.
+	virtual std::vector<double> d2Sigma_dq2_dEe_Ionization(const std::vector<double>& qs, double Ee, double vDM, const Atomic_Electron& shell) const;
+	virtual double d2Sigma_dq2_dEe_Crystal(double q, double Ee, double vDM, const Crystal& crystal) const { return 0.0; };
 
 	// Reference cross sections
 	virtual double Sigma_Proton() const { return 0.0; };
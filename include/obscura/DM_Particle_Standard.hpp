@@ -80,6 +80,8 @@ class DM_Particle_SI : public DM_Particle_Standard
 	explicit DM_Particle_SI(double mDM);
 	DM_Particle_SI(double mDM, double sigmaP);
 
+	virtual DM_Particle_SI* Clone() const override { return new DM_Particle_SI(*this); };
+
 	void Set_FormFactor_DM(std::string ff, double mMed = -1.0);
 	void Set_Mediator_Mass(double m);
 
@@ -88,8 +90,9 @@ class DM_Particle_SI : public DM_Particle_Standard
 
 	// Differential cross section for electron targets
 	virtual double dSigma_dq2_Electron(double q, double vDM, double param = -1.0) const override;
-	virtual double d2Sigma_dq2_dEe_Ionization(double q, double Ee, double vDM, Atomic_Electron& shell) const override;
-	virtual double d2Sigma_dq2_dEe_Crystal(double q, double Ee, double vDM, Crystal& crystal) const override;
+	virtual double d2Sigma_dq2_dEe_Ionization(double q, double Ee, double vDM, const Atomic_Electron& shell) const override;
+	virtual std::vector<double> d2Sigma_dq2_dEe_Ionization(const std::vector<double>& qs, double Ee, double vDM, const Atomic_Electron& shell) const override;
+	virtual double d2Sigma_dq2_dEe_Crystal(double q, double Ee, double vDM, const Crystal& crystal) const override;
 
 	// Total cross sections
 	virtual double Sigma_Total_Nucleus(const Isotope& isotope, double vDM = 1e-3, double param = -1.0) const override;
@@ -117,6 +120,8 @@ class DM_Particle_SD : public DM_Particle_Standard
 	explicit DM_Particle_SD(double mDM);
 	DM_Particle_SD(double mDM, double sigmaP);
 
+	virtual DM_Particle_SD* Clone() const override { return new DM_Particle_SD(*this); };
+
 	// Differential cross sections with nuclear isotopes, elements, and electrons
 	virtual double dSigma_dq2_Nucleus(double q, const Isotope& target, double vDM, double param = -1.0) const override;
 	virtual double dSigma_dq2_Electron(double q, double vDM, double param = -1.0) const override;
@@ -0,0 +1,92 @@
+#ifndef __Data_Pack_hpp_
+#define __Data_Pack_hpp_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "version.hpp"
+
+namespace obscura
+{
+
+//0. Read-only memory mapping of the binary files, which start with an 8 character magic string, a 32-bit version, and a 32-bit byte order marker.
+class Mapped_File
+{
+  private:
+	const char* data;
+	std::size_t size;
+
+  public:
+	static const std::uint32_t byte_order_marker;
+
+	Mapped_File();
+	~Mapped_File();
+	Mapped_File(const Mapped_File&) = delete;
+	Mapped_File& operator=(const Mapped_File&) = delete;
+
+	// Returns false, if the file does not exist or is shorter than the header.
+	bool Map(const std::string& filepath, std::size_t header_size);
+	void Unmap();
+	// Description of the problem, if the magic string, version, or byte order do not match, and an empty string otherwise.
+	std::string Check_Header(const char* magic, std::uint32_t version, const std::string& file_type) const;
+
+	bool Is_Mapped() const;
+	const char* Data() const;
+	std::size_t Size() const;
+};
+
+//1. Binary data pack
+// All numerical tables of the data/ folder in one indexed binary file with a version header and checksums.
+// The pack is memory-mapped, i.e. tables are read without any text parsing.
+// Layout: header | tables (native doubles, row-major) | index (key, offset, rows, columns, checksum, source size and time).
+class Data_Pack
+{
+  private:
+	struct Entry
+	{
+		std::uint64_t offset, rows, columns, checksum;
+		std::uint64_t source_size, source_time;
+	};
+	std::string path;
+	Mapped_File file;
+	std::map<std::string, Entry> index;
+
+	const Entry* Find_Entry(const std::string& key) const;
+
+  public:
+	static const std::uint32_t version;
+
+	Data_Pack();
+	explicit Data_Pack(const std::string& filepath);
+	Data_Pack(const Data_Pack&) = delete;
+	Data_Pack& operator=(const Data_Pack&) = delete;
+
+	bool Is_Open() const;
+	unsigned int Number_Of_Tables() const;
+	std::vector<std::string> Keys() const;
+
+	// Keys are file paths relative to the data folder, e.g. "Form_Factors_Ionization/Xe_5p.txt".
+	// Tables with a wrong checksum are dropped when the pack is opened. The lookup fails for those, or if the source file has changed after the pack was written.
+	bool Contains(const std::string& key) const;
+	bool Import_Table(const std::string& key, std::vector<std::vector<double>>& table) const;
+};
+
+// Convert all numerical tables in data_folder into a binary data pack. Returns the number of packed tables.
+// Each line has to consist of numbers, optionally preceded by one label (e.g. the element name in Nuclear_Data.txt), which is dropped.
+// Files with any other content are skipped.
+extern unsigned int Create_Data_Pack(const std::string& data_folder = PROJECT_DIR "data/", const std::string& pack_path = PROJECT_DIR "data/obscura_data.pack");
+
+// The process-wide pack in data/obscura_data.pack (opened once on first use).
+extern const Data_Pack& Default_Data_Pack();
+
+//2. Import functions with the same interface as libphysica::Import_Table/List.
+// Files inside the data folder are read from the default pack if it contains an up-to-date version of them.
+// Otherwise, the text file is imported.
+extern std::vector<std::vector<double>> Import_Data_Table(const std::string& filepath, std::vector<double> dimensions = {}, unsigned int ignored_initial_lines = 0);
+extern std::vector<double> Import_Data_List(const std::string& filepath, double dimension = 1.0, unsigned int ignored_initial_lines = 0);
+
+}	// namespace obscura
+
+#endif
@@ -1,16 +1,43 @@
 #ifndef __Direct_Detection_hpp_
 #define __Direct_Detection_hpp_
 
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "obscura/DM_Distribution.hpp"
+#include "obscura/DM_Halo_Models.hpp"
 #include "obscura/DM_Particle.hpp"
+#include "obscura/Optimum_Interval.hpp"
 
 namespace obscura
 {
 
+// CDF of the maximum gap's expected number of events x for a total expectation value mu [Yellin, arXiv:physics/0203002]
+extern double CDF_Maximum_Gap(double x, double mu);
+
+// Halo-independent response of a detector to the eta function on a grid of vMin values, for a given DM particle.
+// All rates are linear in DM_density * eta(vMin), so the signals of any DM distribution follow from one matrix-vector product.
+// Between the grid points, the eta function is interpolated linearly. The grid should cover the distributions' speed domains.
+struct Halo_Response_Matrix
+{
+	std::string statistical_analysis;
+	std::vector<double> vMin_grid;
+	// Rows: DM signals (one row for 'Poisson'), columns: vMin grid points, per unit DM density.
+	std::vector<std::vector<double>> matrix;
+
+	std::vector<double> DM_Signals(const DM_Distribution& DM_distr) const;
+	// Signals of all ensemble members, indexed as [member][signal].
+	std::vector<std::vector<double>> DM_Signals(const Halo_Ensemble& ensemble) const;
+};
+
 // DM Detector base class, which provides the statistical methods and energy bins.
+// Thread safety: All const member functions (spectra, signals, likelihoods, p-values, limits) can be called concurrently
+// from many threads for the same detector and distribution, as long as no thread calls a non-const function (Set_..., Use_..., Import_...) at the same time.
+// Functions taking a non-const DM_Particle& (Upper_Limit, Upper_Limit_Curve, Log_Likelihood_Scan) modify and restore the particle, so each thread needs its own particle.
 class DM_Detector
 {
   protected:
@@ -18,7 +45,8 @@ class DM_Detector
 	double exposure, flat_efficiency;
 
 	//DM functions
-	virtual double Maximum_Energy_Deposit(const DM_Particle& DM, const DM_Distribution& DM_distr) const { return 0.0; };
+	// Kinematic endpoint of the spectrum, above which dRdE vanishes. Without an override, the spectrum is not truncated.
+	virtual double Maximum_Energy_Deposit(const DM_Particle& DM, const DM_Distribution& DM_distr) const { return std::numeric_limits<double>::infinity(); };
 
 	//Statistics
 	std::string statistical_analysis;
@@ -27,6 +55,7 @@ class DM_Detector
 	void Initialize_Poisson();
 	unsigned long int observed_events;
 	double expected_background;
+	double P_Value_Poisson(double DM_expectation_value) const;
 
 	// (b) Binned Poisson statistics
 	void Initialize_Binned_Poisson(unsigned bins);
@@ -34,55 +63,87 @@ class DM_Detector
 	std::vector<double> bin_efficiencies;
 	std::vector<unsigned long int> bin_observed_events;
 	std::vector<double> bin_expected_background;
-
-	// Fiducial values used for finding upper limits with (binned) Poisson statistics
-	// To find a limit, the (binned) expecation values are only computed once per mass, and then re-scaled.
-	bool using_fiducial_values = false;
-	double fiducial_coupling   = 0.0;
-	double fiducial_signals	   = 0.0;
-	std::vector<double> fiducial_spectrum;
+	double P_Value_Binned_Poisson(const std::vector<double>& DM_expectation_values) const;
 
 	// (c) Maximum gap a'la Yellin
 	std::vector<double> maximum_gap_energy_data;
-	double P_Value_Maximum_Gap(const DM_Particle& DM, DM_Distribution& DM_distr);
+	std::vector<double> Maximum_Gap_Expectation_Values(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	double P_Value_Maximum_Gap(const std::vector<double>& gaps, double rescaling = 1.0) const;
+	double P_Value_Maximum_Gap(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
+	// (d) Optimum interval a'la Yellin, based on the same gaps as the maximum gap method
+	std::shared_ptr<const Optimum_Interval_Table> optimum_interval_table;
+	std::shared_ptr<std::atomic<bool>> optimum_interval_fallback_warned;
+	double P_Value_Optimum_Interval(const std::vector<double>& gaps, double rescaling = 1.0) const;
 
 	//Energy spectrum
 	double energy_threshold, energy_max;
 
+	// Adaptive sampling of the spectrum for the trapezoidal rule. The intervals of the initial grid are bisected in log(E)
+	// until the error estimate of the integral is below the relative accuracy. Returns the estimated absolute error of the integral.
+	double spectrum_accuracy;
+	double Sample_dRdE(std::vector<double>& energies, std::vector<double>& spectrum, const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	// Joint sampling of several detectors' spectra, where an interval is bisected until it has converged for every detector. Returns the estimated absolute errors of the integrals.
+	// With bin_accuracy, the accuracy refers to the content of each detector's energy bins instead of the whole integral, where the bin edges have to be among the energies.
+	static std::vector<double> Sample_dRdE(const std::vector<const DM_Detector*>& detectors, std::vector<double>& energies, std::vector<std::vector<double>>& spectra, const DM_Particle& DM, const DM_Distribution& DM_distr, bool bin_accuracy = false);
+	// Whether the signals of the chosen analysis are integrals of the adaptively sampled spectrum, so that they respect the spectrum accuracy.
+	virtual bool Signals_Use_Spectrum_Accuracy() const { return true; };
+
 	// (a) Poisson: Energy threshold
 	bool using_energy_threshold;
 
 	// (b) Binned Poisson: Energy bins
 	bool using_energy_bins;
 	std::vector<double> bin_energies;
-	std::vector<double> DM_Signals_Energy_Bins(const DM_Particle& DM, DM_Distribution& DM_distr);
+	std::vector<double> DM_Signals_Energy_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
 
 	void Print_Summary_Base(int MPI_rank = 0) const;
 
+	std::vector<std::vector<double>> Log_Likelihood_Scan_Mass(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& couplings) const;
+	std::vector<std::vector<double>> Upper_Limit_Curve_Parallel(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, double certainty, unsigned int threads) const;
+
   public:
 	std::string name;
 	DM_Detector()
-	: targets("base targets"), exposure(0.0), flat_efficiency(1.0), statistical_analysis("Poisson"), observed_events(0), expected_background(0.0), number_of_bins(0), energy_threshold(0), energy_max(0), using_energy_threshold(false), using_energy_bins(false), name("base name") {};
+	: targets("base targets"), exposure(0.0), flat_efficiency(1.0), statistical_analysis("Poisson"), observed_events(0), expected_background(0.0), number_of_bins(0), energy_threshold(0), energy_max(0), spectrum_accuracy(1.0e-4), using_energy_threshold(false), using_energy_bins(false), name("base name") {};
 	DM_Detector(std::string label, double expo, std::string target_type)
-	: targets(target_type), exposure(expo), flat_efficiency(1.0), statistical_analysis("Poisson"), observed_events(0), expected_background(0.0), number_of_bins(0), energy_threshold(0), energy_max(0), using_energy_threshold(false), using_energy_bins(false), name(label) {};
+	: targets(target_type), exposure(expo), flat_efficiency(1.0), statistical_analysis("Poisson"), observed_events(0), expected_background(0.0), number_of_bins(0), energy_threshold(0), energy_max(0), spectrum_accuracy(1.0e-4), using_energy_threshold(false), using_energy_bins(false), name(label) {};
+	virtual ~DM_Detector() {};
 
-	std::string Target_Particles();
+	// Polymorphic copy, e.g. to give each thread its own instance. Derived classes should override this function.
+	virtual DM_Detector* Clone() const { return new DM_Detector(*this); };
+
+	std::string Target_Particles() const;
 
 	void Set_Flat_Efficiency(double eff);
 
 	//DM functions
 	virtual double Minimum_DM_Speed(const DM_Particle& DM) const { return 0.0; };
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const { return 0.0; };
-	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) { return 0.0; };
-	virtual double DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr);
-	double DM_Signal_Rate_Total(const DM_Particle& DM, DM_Distribution& DM_distr);
-	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr);
+	virtual double dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const { return 0.0; };
+	// Spectrum at many energies. Derived classes can override this function to share work between the energies.
+	virtual std::vector<double> dRdE(const std::vector<double>& energies, const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	virtual double DM_Signals_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	// Integral of dRdE over [E_min, E_max], sampled adaptively up to the kinematic endpoint. The achieved error estimate is returned via 'error'.
+	double Integrate_dRdE(double E_min, double E_max, const DM_Particle& DM, const DM_Distribution& DM_distr, double& error) const;
+	void Set_Spectrum_Accuracy(double relative_accuracy);
+	double DM_Signal_Rate_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	// Energy-binned signals of several detectors with the same target particles. The spectrum is sampled adaptively once on the union of all bin edges,
+	// and every detector's bins are read off the cumulative integral on that grid. Returns [detector][bin].
+	static std::vector<std::vector<double>> DM_Signals_Energy_Bins(const std::vector<const DM_Detector*>& detectors, const DM_Particle& DM, const DM_Distribution& DM_distr);
 
 	//Statistics
-	double Log_Likelihood(const DM_Particle& DM, DM_Distribution& DM_distr);
-	double Likelihood(const DM_Particle& DM, DM_Distribution& DM_distr);
-	std::vector<std::vector<double>> Log_Likelihood_Scan(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings);
-	double P_Value(const DM_Particle& DM, DM_Distribution& DM_distr);
+	double Log_Likelihood(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	double Likelihood(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	// The signals are computed once per mass and re-scaled for each coupling. The rows {mass, coupling, log-likelihood} of each mass are passed to 'output' in the order of the masses.
+	void Log_Likelihood_Scan(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings, const std::function<void(const std::vector<std::vector<double>>&)>& output, unsigned int threads = 1) const;
+	std::vector<std::vector<double>> Log_Likelihood_Scan(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings, unsigned int threads = 1) const;
+	double P_Value(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
+	// Halo-independent response matrix, computed once per DM particle. The DM particle has to use the eta function.
+	Halo_Response_Matrix Compute_Halo_Response_Matrix(const DM_Particle& DM, const std::vector<double>& vMin_grid) const;
+	double Log_Likelihood(const Halo_Response_Matrix& response_matrix, const DM_Distribution& DM_distr) const;
 
 	// (a) Poisson
 	void Set_Observed_Events(unsigned long int N);
@@ -96,6 +157,10 @@ class DM_Detector
 	// (c) Maximum gap
 	void Use_Maximum_Gap(std::vector<double> energies);
 
+	// (d) Optimum interval, with the calibration table generated by ./obscura_optimum_interval
+	// If the total expectation value lies outside the table's range of mu, the maximum gap p-value is used instead (with a warning on the first occurrence).
+	void Use_Optimum_Interval(std::vector<double> energies, const std::string& table_path = PROJECT_DIR "data/optimum_interval.table");
+
 	//Energy spectrum
 	// (a) Poisson
 	void Use_Energy_Threshold(double Ethr, double Emax);
@@ -103,8 +168,9 @@ class DM_Detector
 	void Use_Energy_Bins(double Emin, double Emax, int bins);
 
 	//Limits/Constraints
-	double Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty = 0.95);
-	std::vector<std::vector<double>> Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty = 0.95);
+	double Upper_Limit(DM_Particle& DM, const DM_Distribution& DM_distr, double certainty = 0.95) const;
+	// With threads > 1, the masses are distributed over a pool of threads, each with its own copy of DM (threads = 0: use all available cores).
+	std::vector<std::vector<double>> Upper_Limit_Curve(DM_Particle& DM, const DM_Distribution& DM_distr, std::vector<double> masses, double certainty = 0.95, unsigned int threads = 1) const;
 
 	virtual void Print_Summary(int MPI_rank = 0) const { Print_Summary_Base(MPI_rank); };
 };
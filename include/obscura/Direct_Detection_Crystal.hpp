@@ -13,9 +13,15 @@ namespace obscura
 {
 
 //1. Event spectra and rates
-extern double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal);
-extern double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal);
-extern double R_total_Crystal(int Qthreshold, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal);
+extern double dRdEe_Crystal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal);
+extern double R_Q_Crystal(int Q, const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal);
+extern double R_total_Crystal(int Qthreshold, const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal);
+
+// Spectrum dR/dEe at all tabulated energies Ee = (Ei+1)*dE, computed in one pass over the (q, Ee) grid.
+// The rates R_Q and R_total can then be read out of the spectrum without re-evaluating it.
+extern std::vector<double> dRdEe_Crystal_Spectrum(const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal);
+extern double R_Q_Crystal(int Q, const std::vector<double>& spectrum, const Crystal& target_crystal);
+extern double R_total_Crystal(int Qthreshold, const std::vector<double>& spectrum, const Crystal& target_crystal);
 
 //2. Electron recoil direct detection experiment with semiconductor target
 class DM_Detector_Crystal : public DM_Detector
@@ -34,18 +40,23 @@ class DM_Detector_Crystal : public DM_Detector
 
 	// (b) Binned Poisson: Energy bins
 	bool using_Q_bins;
-	std::vector<double> DM_Signals_Q_Bins(const DM_Particle& DM, DM_Distribution& DM_distr);
+	std::vector<double> DM_Signals_Q_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
+	virtual bool Signals_Use_Spectrum_Accuracy() const override { return !using_Q_threshold && !using_Q_bins; };
 
   public:
 	DM_Detector_Crystal();
 	DM_Detector_Crystal(std::string label, double expo, std::string crys);
 
+	virtual DM_Detector_Crystal* Clone() const override { return new DM_Detector_Crystal(*this); };
+
 	//DM functions
 	virtual double Minimum_DM_Speed(const DM_Particle& DM) const override;
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
-	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) override;
-	virtual double DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr) override;
-	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr) override;
+	using DM_Detector::dRdE;
+	virtual double dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
+	virtual double DM_Signals_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
+	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 
 	//Q spectrum
 	// (a) Poisson
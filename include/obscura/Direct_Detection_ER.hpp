@@ -6,8 +6,8 @@
 namespace obscura
 {
 //1. Event spectra and rates
-extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, double m_nucleus, Atomic_Electron& shell);
-extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom);
+extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, double m_nucleus, const Atomic_Electron& shell);
+extern double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom);
 
 //2. Detector class for ionization experiments from DM-electron scatterings.
 class DM_Detector_Ionization_ER : public DM_Detector_Ionization
@@ -17,7 +17,9 @@ class DM_Detector_Ionization_ER : public DM_Detector_Ionization
 	DM_Detector_Ionization_ER(std::string label, double expo, std::string atom);
 	DM_Detector_Ionization_ER(std::string label, double expo, std::vector<std::string> atoms, std::vector<double> mass_fractions = {});
 
-	virtual double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell) override;
+	virtual DM_Detector_Ionization_ER* Clone() const override { return new DM_Detector_Ionization_ER(*this); };
+
+	virtual double dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell) const override;
 };
 
 }	// namespace obscura
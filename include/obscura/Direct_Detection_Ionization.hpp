@@ -27,7 +27,7 @@ class DM_Detector_Ionization : public DM_Detector
 	bool using_electron_threshold;
 	// (b) Binned Poisson: Electron bins
 	bool using_electron_bins;
-	std::vector<double> DM_Signals_Electron_Bins(const DM_Particle& DM, DM_Distribution& DM_distr);
+	std::vector<double> DM_Signals_Electron_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
 
 	//PE (or S2) spectrum
 	unsigned int PE_threshold, PE_max;
@@ -39,45 +39,57 @@ class DM_Detector_Ionization : public DM_Detector
 	// (b) Binned Poisson: PE bins (S2)
 	bool using_S2_bins;
 	std::vector<unsigned int> S2_bin_ranges;
-	double R_S2_Bin(unsigned int S2_1, unsigned int S2_2, const DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> electron_spectrum = {});
-	std::vector<double> DM_Signals_PE_Bins(const DM_Particle& DM, DM_Distribution& DM_distr);
+	// Response matrix of the PE bins (or the PE threshold window) to ne = 1, ..., ne_max including the PE efficiencies.
+	std::vector<std::vector<double>> PE_response_matrix;
+	void Compute_PE_Response_Matrix();
+	std::vector<double> DM_Signals_PE_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
+	// The electron and PE spectra are sums over the fixed k grid, and the energy threshold integrates over each shell separately.
+	virtual bool Signals_Use_Spectrum_Accuracy() const override;
 
   public:
 	DM_Detector_Ionization(std::string label, double expo, std::string target_particles, std::string atom);
 	DM_Detector_Ionization(std::string label, double expo, std::string target_particles, std::vector<std::string> atoms, std::vector<double> mass_fractions = {});
 
+	virtual DM_Detector_Ionization* Clone() const override { return new DM_Detector_Ionization(*this); };
+
 	//DM functions from the base class
 	virtual double Minimum_DM_Speed(const DM_Particle& DM) const override;
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 
-	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) override;
-	virtual double DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr) override;
-	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr) override;
+	using DM_Detector::dRdE;
+	virtual double dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
+	virtual double DM_Signals_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
+	virtual std::vector<double> DM_Signals_Binned(const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 
 	//Energy spectrum
-	virtual double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell);
-	double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom);
+	virtual double dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell) const;
+	double dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom) const;
 
 	//Electron spectrum
-	double R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr, double W, const Nucleus& nucleus, Atomic_Electron& shell);
-	double R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom);
-	double R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr);
+	double R_ne(unsigned int ne, const DM_Particle& DM, const DM_Distribution& DM_distr, double W, const Nucleus& nucleus, const Atomic_Electron& shell) const;
+	double R_ne(unsigned int ne, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom) const;
+	double R_ne(unsigned int ne, const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+	// Spectrum R_ne for ne = 1, ..., ne_maximum in a single pass over the k grid (entry [ne-1]).
+	std::vector<double> Electron_Spectrum(unsigned int ne_maximum, const DM_Particle& DM, const DM_Distribution& DM_distr, double W, const Nucleus& nucleus, const Atomic_Electron& shell) const;
+	std::vector<double> Electron_Spectrum(unsigned int ne_maximum, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom) const;
+	std::vector<double> Electron_Spectrum(unsigned int ne_maximum, const DM_Particle& DM, const DM_Distribution& DM_distr) const;
 	// (a) Poisson: Electron threshold
 	void Use_Electron_Threshold(unsigned int ne_thr, unsigned int nemax = 0);
 	// (b) Binned Poisson: Electron bins
 	void Use_Electron_Bins(unsigned int ne_thr, unsigned int N_bins);
 
 	//PE (or S2) spectrum
-	double R_S2(unsigned int S2, const DM_Particle& DM, DM_Distribution& DM_distr, double W, const Nucleus& nucleus, Atomic_Electron& shell, std::vector<double> electron_spectrum = {});
-	double R_S2(unsigned int S2, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom, std::vector<double> electron_spectrum = {});
-	double R_S2(unsigned int S2, const DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> electron_spectrum = {});
+	double R_S2(unsigned int S2, const DM_Particle& DM, const DM_Distribution& DM_distr, double W, const Nucleus& nucleus, const Atomic_Electron& shell, std::vector<double> electron_spectrum = {}) const;
+	double R_S2(unsigned int S2, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom, std::vector<double> electron_spectrum = {}) const;
+	double R_S2(unsigned int S2, const DM_Particle& DM, const DM_Distribution& DM_distr, std::vector<double> electron_spectrum = {}) const;
 
 	// (a) Poisson: PE threshold (S2)
-	void Use_PE_Threshold(double S2mu, double S2sigma, unsigned int nPE_thr, unsigned int nPE_max);
+	void Use_PE_Threshold(double S2mu, double S2sigma, unsigned int nPE_thr, unsigned int nPE_max, unsigned int nemax = 15);
 	void Import_Trigger_Efficiency_PE(std::string filename);
 	void Import_Acceptance_Efficiency_PE(std::string filename);
 	// (b) Binned Poisson: PE bins (S2)
-	void Use_PE_Bins(double S2mu, double S2sigma, const std::vector<unsigned int>& bin_ranges);
+	void Use_PE_Bins(double S2mu, double S2sigma, const std::vector<unsigned int>& bin_ranges, unsigned int nemax = 15);
 
 	virtual void Print_Summary(int MPI_rank = 0) const override;
 };
@@ -6,19 +6,25 @@
 namespace obscura
 {
 //1. Event spectra and rates
-extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& isotope, Atomic_Electron& shell);
-extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell);
-extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom);
+extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Isotope& isotope, const Atomic_Electron& shell);
+extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell);
+extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom);
 
 //2. Detector class for ionization experiments from DM-electron scatterings.
 class DM_Detector_Ionization_Migdal : public DM_Detector_Ionization
 {
+  private:
+	// Each point of the spectrum is an integral over the nuclear recoil energy with fixed accuracy.
+	virtual bool Signals_Use_Spectrum_Accuracy() const override { return false; };
+
   public:
 	DM_Detector_Ionization_Migdal();
 	DM_Detector_Ionization_Migdal(std::string label, double expo, std::string atom);
 	DM_Detector_Ionization_Migdal(std::string label, double expo, std::vector<std::string> atoms, std::vector<double> mass_fractions = {});
 
-	virtual double dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell) override;
+	virtual DM_Detector_Ionization_Migdal* Clone() const override { return new DM_Detector_Ionization_Migdal(*this); };
+
+	virtual double dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell) const override;
 };
 
 }	// namespace obscura
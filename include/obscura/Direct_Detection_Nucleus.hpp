@@ -15,8 +15,8 @@ namespace obscura
 {
 
 //1. Theoretical nuclear recoil spectrum [events per time, energy, and target mass]
-extern double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope);
-extern double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& target_nucleus);
+extern double dRdER_Nucleus(double ER, const DM_Particle& DM, const DM_Distribution& DM_distr, const Isotope& target_isotope);
+extern double dRdER_Nucleus(double ER, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& target_nucleus);
 
 //2. Nuclear recoil direct detection experiment
 class DM_Detector_Nucleus : public DM_Detector
@@ -26,10 +26,35 @@ class DM_Detector_Nucleus : public DM_Detector
 	std::vector<Nucleus> target_nuclei;
 	std::vector<double> relative_mass_fractions;
 
+	// All isotopes of the target nuclei as a structure of arrays. The weights are the relative mass fractions times the isotopic abundances.
+	struct Isotope_Table
+	{
+		std::vector<double> masses, weights;
+		std::vector<unsigned int> nuclei, isotopes;
+	};
+	Isotope_Table isotope_table;
+	void Tabulate_Isotopes();
+	// Theoretical spectra [nucleus][ER] of all isotopes, evaluated isotope by isotope for the whole grid of recoil energies.
+	std::vector<std::vector<double>> Nuclear_Recoil_Spectra(const std::vector<double>& ERs, const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
 	//Experimental parameters
 	double energy_resolution;
 	bool using_efficiency_tables;
 	std::vector<libphysica::Interpolation> efficiencies;
+	double Efficiency(double E, unsigned int nucleus) const;
+	// Theoretical spectrum at a single recoil energy ER, weighted with the efficiencies at the observed energy E. Avoids the allocations of Nuclear_Recoil_Spectra() in the integrand of the energy resolution.
+	double Detected_Recoil_Spectrum(double ER, double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const;
+
+	// Gaussian energy resolution as a banded matrix, which maps the theoretical spectrum on a uniform recoil energy grid
+	// ER_min + node * dER to the observed energies. Only the grid nodes inside the energies' windows are listed.
+	struct Resolution_Kernel
+	{
+		double ER_min, dER;
+		std::vector<unsigned int> nodes;
+		std::vector<unsigned int> first_node;
+		std::vector<std::vector<double>> weights;
+	};
+	Resolution_Kernel Compute_Resolution_Kernel(const std::vector<double>& energies) const;
 
 	virtual double Maximum_Energy_Deposit(const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 
@@ -37,13 +62,17 @@ class DM_Detector_Nucleus : public DM_Detector
 	DM_Detector_Nucleus();
 	DM_Detector_Nucleus(std::string label, double expo, std::vector<Nucleus> nuclei, std::vector<double> abund = {});
 
+	virtual DM_Detector_Nucleus* Clone() const override { return new DM_Detector_Nucleus(*this); };
+
 	void Set_Resolution(double res);
 	void Import_Efficiency(std::string filename, double dim);
 	void Import_Efficiency(std::vector<std::string> filenames, double dim);
 
 	virtual double Minimum_DM_Speed(const DM_Particle& DM) const override;
 	virtual double Minimum_DM_Mass(DM_Particle& DM, const DM_Distribution& DM_distr) const override;
-	virtual double dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr) override;
+	virtual double dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
+	// All energies share one pass over the isotopes. With a finite energy resolution, the theoretical spectrum is evaluated only once on a recoil energy grid and then convoluted with the Gaussian.
+	virtual std::vector<double> dRdE(const std::vector<double>& energies, const DM_Particle& DM, const DM_Distribution& DM_distr) const override;
 
 	virtual void Print_Summary(int MPI_rank = 0) const override;
 };
@@ -0,0 +1,61 @@
+#ifndef __Optimum_Interval_hpp_
+#define __Optimum_Interval_hpp_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "obscura/Data_Pack.hpp"
+#include "version.hpp"
+
+namespace obscura
+{
+
+//1. Optimum interval method a'la Yellin [arXiv:physics/0203002]
+// Largest expected number of events x_n of any interval with at most n events, for n = 0, ..., n_max.
+// The gaps are the expected numbers of events between the sorted observed events, including the boundaries of the energy range.
+extern std::vector<double> Optimum_Interval_Maxima(const std::vector<double>& gaps, unsigned int n_max);
+
+// Monte Carlo calibration table of the optimum interval method. For each total expectation value mu of the grid, it contains the quantiles of
+// (a) x_n / mu, which define C_n(x, mu), the probability that all intervals with at most n events have less than x expected events, and
+// (b) C_max = max_n C_n(x_n, mu), the test statistic.
+// The table is memory-mapped, i.e. the quantiles are read without parsing or copying.
+// Layout: header | mu grid | x_n / mu quantiles [mu][n][quantile] | C_max quantiles [mu][quantile] (native doubles).
+class Optimum_Interval_Table
+{
+  private:
+	std::string path;
+	Mapped_File file;
+	std::uint32_t number_of_mus, n_max, number_of_quantiles;
+	const double* mu_grid;
+	const double* x_quantiles;
+	const double* C_max_quantiles;
+
+	double P_Value(unsigned int mu_index, const std::vector<double>& x_fractions) const;
+
+  public:
+	static const std::uint32_t version;
+
+	explicit Optimum_Interval_Table(const std::string& filepath);
+	Optimum_Interval_Table(const Optimum_Interval_Table&) = delete;
+	Optimum_Interval_Table& operator=(const Optimum_Interval_Table&) = delete;
+
+	bool Is_Open() const;
+	double Minimum_Mu() const;
+	double Maximum_Mu() const;
+	unsigned int Maximum_Interval_Events() const;
+	// Whether the total expectation value mu lies within the table's range of mu.
+	bool Covers(double mu) const;
+
+	// p-value of the optimum interval statistic for the given gaps, interpolated in log(mu) between the grid points.
+	// Outside the table's range of mu, the (conservative) maximum gap p-value is returned.
+	double P_Value(const std::vector<double>& gaps) const;
+};
+
+// Generate the calibration table by simulating experiments without background for each mu of the grid, distributed over threads (0: all cores).
+// The result does not depend on the number of threads. Returns false, if the file could not be written.
+extern bool Create_Optimum_Interval_Table(const std::vector<double>& mu_grid, unsigned int n_max = 50, unsigned int samples = 10000, unsigned int quantiles = 201, unsigned int threads = 0, unsigned long int seed = 1, const std::string& table_path = PROJECT_DIR "data/optimum_interval.table");
+
+}	// namespace obscura
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef __Target_Atom_hpp_
 #define __Target_Atom_hpp_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,16 +16,50 @@ namespace obscura
 //1. Kinematic functions
 extern double vMinimal_Electrons(double q, double Delta_E, double mDM);
 
-//2. Bound electrons in isolated atoms
+//2. Bilinear interpolation on logarithmically spaced grids (e.g. created with libphysica::Log_Space).
+// The cell is found arithmetically instead of searching the grid, and the table is stored contiguously in row-major order.
+class Log_Grid_Interpolation_2D
+{
+  private:
+	std::vector<double> x_grid, y_grid;
+	std::vector<double> values;
+	double log_x_min, log_y_min, inverse_dlog_x, inverse_dlog_y;
+
+	unsigned int Index(double log_value, double log_min, double inverse_dlog, const std::vector<double>& grid, double value) const;
+
+  public:
+	Log_Grid_Interpolation_2D();
+	Log_Grid_Interpolation_2D(double x_min, double x_max, double y_min, double y_max, const std::vector<std::vector<double>>& table);
+
+	const std::vector<double>& X_Grid() const { return x_grid; }
+	const std::vector<double>& Y_Grid() const { return y_grid; }
+
+	double operator()(double x, double y) const;
+	// Batched evaluation of the points (xs[i],ys[i]).
+	std::vector<double> operator()(const std::vector<double>& xs, const std::vector<double>& ys) const;
+};
+
+//3. Bound electrons in isolated atoms
+// Immutable ionization form factor table of one atomic shell.
+struct Ionization_Form_Factor_Table
+{
+	Log_Grid_Interpolation_2D interpolation;
+
+	Ionization_Form_Factor_Table(const std::string& shell_name, double k_min, double k_max, double q_min, double q_max);
+};
+
+// Process-wide registry of the form factor tables. Each table is imported once and then shared by all Atomic_Electron instances.
+extern std::shared_ptr<const Ionization_Form_Factor_Table> Get_Ionization_Form_Factor_Table(const std::string& shell_name, double k_min, double k_max, double q_min, double q_max);
+
 struct Atomic_Electron
 {
 	// Ionization form factor tables
 	double k_min, k_max, q_min, q_max;
 	double dlogk, dlogq;
 	unsigned int Nk, Nq;
-	std::vector<double> k_Grid = {};
-	std::vector<double> q_Grid = {};
-	libphysica::Interpolation_2D form_factor_interpolation;
+	std::shared_ptr<const Ionization_Form_Factor_Table> form_factor_table;
+	const std::vector<double>& k_Grid() const { return form_factor_table->interpolation.X_Grid(); }
+	const std::vector<double>& q_Grid() const { return form_factor_table->interpolation.Y_Grid(); }
 
 	unsigned int n, l;
 	std::string name;
@@ -34,7 +69,8 @@ struct Atomic_Electron
 	Atomic_Electron(std::string element, int N, int L, double Ebinding, double kMin, double kMax, double qMin, double qMax, unsigned int neSecondary = 0);
 
 	//Squared ionization form factor.
-	double Ionization_Form_Factor(double q, double E);
+	double Ionization_Form_Factor(double q, double E) const;
+	std::vector<double> Ionization_Form_Factor(const std::vector<double>& qs, const std::vector<double>& Es) const;
 
 	void Print_Summary(unsigned int MPI_rank = 0) const;
 };
@@ -51,7 +87,7 @@ struct Atom
 
 	double Lowest_Binding_Energy() const;
 
-	Atomic_Electron Electron(unsigned int n, unsigned int l);
+	const Atomic_Electron& Electron(unsigned int n, unsigned int l) const;
 
 	// Overloading brackets
 	Atomic_Electron& operator[](int i)
@@ -1,7 +1,8 @@
 #ifndef __Target_Crystal_hpp_
 #define __Target_Crystal_hpp_
 
-#include "libphysica/Numerics.hpp"
+#include <string>
+#include <vector>
 
 namespace obscura
 {
@@ -9,18 +10,24 @@ namespace obscura
 class Crystal
 {
   private:
-	libphysica::Interpolation_2D form_factor_interpolation;
+	// Form factor on the grid q = (qi+1)*dq, E = (Ei+1)*dE, stored contiguously with entry [Ei * N_q + qi].
+	std::vector<double> form_factor_table;
 
   public:
 	std::string name;
 	double dE, dq;
+	unsigned int N_E, N_q;
 	double M_cell;
 	double energy_gap, epsilon;
 	unsigned int Q_max;
 
 	explicit Crystal(std::string target);
 
-	double Crystal_Form_Factor(double q, double E);
+	// Bilinear interpolation, which reduces to a direct table lookup for q and E on the grid.
+	double Crystal_Form_Factor(double q, double E) const;
+	double Crystal_Form_Factor(unsigned int qi, unsigned int Ei) const { return form_factor_table[Ei * N_q + qi]; }
+	// Form factor for all qi at fixed Ei.
+	const double* Crystal_Form_Factor_Row(unsigned int Ei) const { return &form_factor_table[Ei * N_q]; }
 };
 }	// namespace obscura
 
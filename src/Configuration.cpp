@@ -123,7 +123,8 @@ void Configuration::Print_Summary_Base(int MPI_rank)
 		std::cout << "Direct detection constraints" << std::endl
 				  << "\tCertainty level [%]:\t" << 100.0 * constraints_certainty << std::endl
 				  << "\tMass range [GeV]:\t[" << constraints_mass_min << "," << constraints_mass_max << "]" << std::endl
-				  << "\tMass steps:\t\t" << constraints_masses
+				  << "\tMass steps:\t\t" << constraints_masses << std::endl
+				  << "\tThreads:\t\t" << constraints_threads
 				  << SEPARATOR
 				  << std::endl;
 	}
@@ -339,6 +340,19 @@ void Configuration::Construct_DM_Distribution()
 		std::cerr << "Error in obscura::Configuration::Construct_DM_Distribution(): 'DM_distribution' setting " << DM_distribution << " in configuration file not recognized." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+
+	// Optional setting, by default the eta function is tabulated once with 1000 points and shared by all DM masses (0: no table).
+	unsigned int eta_table_points;
+	try
+	{
+		eta_table_points = config.lookup("DM_eta_table_points");
+	}
+	catch(const SettingNotFoundException& nfex)
+	{
+		eta_table_points = 1000;
+	}
+	if(eta_table_points > 0)
+		DM_distr->Tabulate_Eta_Function(eta_table_points);
 }
 
 void Configuration::Construct_DM_Halo_Model(std::string model_label)
@@ -793,6 +807,16 @@ void Configuration::Initialize_Parameters()
 		std::cerr << "Error in Configuration::Initialize_Parameters(): No 'constraints_masses' setting in configuration file." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+
+	// Optional setting, the default is a single thread.
+	try
+	{
+		constraints_threads = config.lookup("constraints_threads");
+	}
+	catch(const SettingNotFoundException& nfex)
+	{
+		constraints_threads = 1;
+	}
 }
 
 }	// namespace obscura
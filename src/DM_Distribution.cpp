@@ -1,7 +1,10 @@
 #include "obscura/DM_Distribution.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iostream>
+#include <typeinfo>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
@@ -15,11 +18,11 @@ using namespace libphysica::natural_units;
 // 1. Abstract base class for DM distributions that can be used to compute direct detection recoil spectra.
 //Constructors:
 DM_Distribution::DM_Distribution()
-: name("DM base distribution"), v_domain(std::vector<double> {0.0, 1.0}), DM_density(0.0), DD_use_eta_function(false)
+: name("DM base distribution"), v_domain(std::vector<double> {0.0, 1.0}), eta_table_dv(0.0), DM_density(0.0), DD_use_eta_function(false)
 {
 }
 DM_Distribution::DM_Distribution(std::string label, double rhoDM, double vMin, double vMax)
-: name(label), v_domain(std::vector<double> {vMin, vMax}), DM_density(rhoDM), DD_use_eta_function(false)
+: name(label), v_domain(std::vector<double> {vMin, vMax}), eta_table_dv(0.0), DM_density(rhoDM), DD_use_eta_function(false)
 {
 }
 
@@ -32,7 +35,7 @@ double DM_Distribution::Maximum_DM_Speed() const
 	return v_domain[1];
 }
 
-double DM_Distribution::PDF_Speed(double v)
+double DM_Distribution::PDF_Speed(double v) const
 {
 	auto integrand = [this, v](double cos_theta, double phi) {
 		libphysica::Vector vel = libphysica::Spherical_Coordinates(v, acos(cos_theta), phi);
@@ -41,7 +44,7 @@ double DM_Distribution::PDF_Speed(double v)
 	return libphysica::Integrate_2D(integrand, -1.0, 1.0, 0.0, 2.0 * M_PI);
 }
 
-double DM_Distribution::CDF_Speed(double v)
+double DM_Distribution::CDF_Speed(double v) const
 {
 	if(v < v_domain[0])
 		return 0.0;
@@ -56,7 +59,23 @@ double DM_Distribution::CDF_Speed(double v)
 	}
 }
 
-double DM_Distribution::PDF_Norm()
+std::vector<double> DM_Distribution::PDF_Speed(const std::vector<double>& vs) const
+{
+	std::vector<double> pdfs(vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+		pdfs[i] = PDF_Speed(vs[i]);
+	return pdfs;
+}
+
+std::vector<double> DM_Distribution::CDF_Speed(const std::vector<double>& vs) const
+{
+	std::vector<double> cdfs(vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+		cdfs[i] = CDF_Speed(vs[i]);
+	return cdfs;
+}
+
+double DM_Distribution::PDF_Norm() const
 {
 	auto integrand = [this](double v) {
 		return PDF_Speed(v);
@@ -64,12 +83,12 @@ double DM_Distribution::PDF_Norm()
 	return libphysica::Integrate(integrand, v_domain[0], v_domain[1], "Trapezoidal");
 }
 
-double DM_Distribution::Differential_DM_Flux(double v, double mDM)
+double DM_Distribution::Differential_DM_Flux(double v, double mDM) const
 {
 	return DM_density / mDM * v * PDF_Speed(v);
 }
 
-double DM_Distribution::Total_DM_Flux(double mDM)
+double DM_Distribution::Total_DM_Flux(double mDM) const
 {
 	auto dFdv = [this, mDM](double v) {
 		return Differential_DM_Flux(v, mDM);
@@ -77,7 +96,7 @@ double DM_Distribution::Total_DM_Flux(double mDM)
 	return libphysica::Integrate(dFdv, v_domain[0], v_domain[1]);
 }
 
-libphysica::Vector DM_Distribution::Average_Velocity()
+libphysica::Vector DM_Distribution::Average_Velocity() const
 {
 	libphysica::Vector v_average(3);
 	for(unsigned int i = 0; i < v_average.Size(); i++)
@@ -90,7 +109,7 @@ libphysica::Vector DM_Distribution::Average_Velocity()
 	return v_average;
 }
 
-double DM_Distribution::Average_Speed(double vMin)
+double DM_Distribution::Average_Speed(double vMin) const
 {
 	// 1. Check the domain.
 	bool agerage_over_subdomain = true;
@@ -118,7 +137,7 @@ double DM_Distribution::Average_Speed(double vMin)
 	return v_average;
 }
 
-double DM_Distribution::Eta_Function_Base(double vMin)
+double DM_Distribution::Eta_Function_Base(double vMin) const
 {
 	if(vMin < v_domain[0])
 	{
@@ -138,12 +157,72 @@ double DM_Distribution::Eta_Function_Base(double vMin)
 	}
 }
 
-double DM_Distribution::Eta_Function(double vMin)
+double DM_Distribution::Eta_Function(double vMin) const
 {
 	return Eta_Function_Base(vMin);
 }
 
-void DM_Distribution::Print_Summary_Base()
+std::vector<double> DM_Distribution::Eta_Function(const std::vector<double>& vMins) const
+{
+	std::vector<double> etas(vMins.size());
+	for(unsigned int i = 0; i < vMins.size(); i++)
+		etas[i] = Eta_Function(vMins[i]);
+	return etas;
+}
+
+void DM_Distribution::Tabulate_Eta_Function(unsigned int v_points)
+{
+	if(v_points < 2)
+	{
+		std::cerr << "Error in obscura::DM_Distribution::Tabulate_Eta_Function(): The table needs at least 2 points, not " << v_points << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	eta_table_dv = (v_domain[1] - v_domain[0]) / (v_points - 1);
+	eta_table.resize(v_points);
+	for(unsigned int i = 0; i < v_points; i++)
+		eta_table[i] = Eta_Function(v_domain[0] + i * eta_table_dv);
+}
+
+void DM_Distribution::Clear_Eta_Table()
+{
+	eta_table.clear();
+	eta_table_dv = 0.0;
+}
+
+void DM_Distribution::Update_Eta_Table()
+{
+	if(Eta_Function_Is_Tabulated())
+		Tabulate_Eta_Function(eta_table.size());
+}
+
+bool DM_Distribution::Eta_Function_Is_Tabulated() const
+{
+	return !eta_table.empty();
+}
+
+double DM_Distribution::Eta_Function_Tabulated(double vMin) const
+{
+	if(eta_table.empty() || vMin < v_domain[0])
+		return Eta_Function(vMin);
+	else if(vMin >= v_domain[1])
+		return 0.0;
+	double x	   = (vMin - v_domain[0]) / eta_table_dv;
+	unsigned int i = std::min<double>(std::floor(x), eta_table.size() - 2);
+	double t	   = x - i;
+	return (1.0 - t) * eta_table[i] + t * eta_table[i + 1];
+}
+
+std::vector<double> DM_Distribution::Eta_Function_Tabulated(const std::vector<double>& vMins) const
+{
+	if(eta_table.empty())
+		return Eta_Function(vMins);
+	std::vector<double> etas(vMins.size());
+	for(unsigned int i = 0; i < vMins.size(); i++)
+		etas[i] = Eta_Function_Tabulated(vMins[i]);
+	return etas;
+}
+
+void DM_Distribution::Print_Summary_Base() const
 {
 	std::cout << "Dark matter distribution - Summary" << std::endl
 			  << "\t" << name << std::endl
@@ -155,13 +234,13 @@ void DM_Distribution::Print_Summary_Base()
 			  << std::endl;
 }
 
-void DM_Distribution::Print_Summary(int mpi_rank)
+void DM_Distribution::Print_Summary(int mpi_rank) const
 {
 	if(mpi_rank == 0)
 		Print_Summary_Base();
 }
 
-void DM_Distribution::Export_PDF_Speed(std::string file_path, int v_points, bool log_scale)
+void DM_Distribution::Export_PDF_Speed(std::string file_path, int v_points, bool log_scale) const
 {
 	auto v_list = log_scale ? libphysica::Log_Space(v_domain[0], v_domain[1], v_points) : libphysica::Linear_Space(v_domain[0], v_domain[1], v_points);
 	auto pdf	= [this](double v) {
@@ -170,7 +249,7 @@ void DM_Distribution::Export_PDF_Speed(std::string file_path, int v_points, bool
 	libphysica::Export_Function(file_path, pdf, v_list, {km / sec, sec / km});
 }
 
-void DM_Distribution::Export_Eta_Function(std::string file_path, int v_points, bool log_scale)
+void DM_Distribution::Export_Eta_Function(std::string file_path, int v_points, bool log_scale) const
 {
 	auto v_list = log_scale ? libphysica::Log_Space(v_domain[0], v_domain[1], v_points) : libphysica::Linear_Space(v_domain[0], v_domain[1], v_points);
 	auto eta	= [this](double v) {
@@ -180,7 +259,7 @@ void DM_Distribution::Export_Eta_Function(std::string file_path, int v_points, b
 }
 
 // 2. Import a tabulated DM distribution from a file (format v[km/sec] :: f(v) [sec/km])
-void Imported_DM_Distribution::Check_Normalization()
+void Imported_DM_Distribution::Check_Normalization() const
 {
 	double norm = pdf_speed.Integrate(v_domain[0], v_domain[1]);
 	if(libphysica::Relative_Difference(norm, 1.0) > 1.0e-3)
@@ -208,7 +287,7 @@ Imported_DM_Distribution::Imported_DM_Distribution(double rho, const std::string
 	Interpolate_Eta();
 }
 
-double Imported_DM_Distribution::PDF_Speed(double v)
+double Imported_DM_Distribution::PDF_Speed(double v) const
 {
 	if(v < v_domain[0] || v > v_domain[1])
 		return 0.0;
@@ -216,7 +295,7 @@ double Imported_DM_Distribution::PDF_Speed(double v)
 		return pdf_speed(v);
 }
 
-double Imported_DM_Distribution::Eta_Function(double vMin)
+double Imported_DM_Distribution::Eta_Function(double vMin) const
 {
 	if(vMin < v_domain[0])
 	{
@@ -229,7 +308,7 @@ double Imported_DM_Distribution::Eta_Function(double vMin)
 		return eta_function(vMin);
 }
 
-void Imported_DM_Distribution::Print_Summary(int mpi_rank)
+void Imported_DM_Distribution::Print_Summary(int mpi_rank) const
 {
 	if(mpi_rank == 0)
 	{
@@ -239,4 +318,141 @@ void Imported_DM_Distribution::Print_Summary(int mpi_rank)
 	}
 }
 
+// 3. Tabulated version of any DM distribution
+namespace
+{
+std::shared_ptr<const DM_Distribution> Clone_Distribution(const DM_Distribution& distr)
+{
+	std::shared_ptr<const DM_Distribution> clone(distr.Clone());
+	if(typeid(*clone) != typeid(distr))
+	{
+		std::cerr << "Error in obscura::Tabulated_DM_Distribution::Tabulated_DM_Distribution(): Clone() is not overridden for the given DM distribution class. Override it, or pass the distribution as a std::shared_ptr." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	return clone;
+}
+}	// namespace
+
+Tabulated_DM_Distribution::Tabulated_DM_Distribution(const DM_Distribution& distr, double rel_accuracy)
+: Tabulated_DM_Distribution(Clone_Distribution(distr), rel_accuracy)
+{
+}
+
+Tabulated_DM_Distribution::Tabulated_DM_Distribution(std::shared_ptr<const DM_Distribution> distr, double rel_accuracy)
+: DM_Distribution("Tabulated DM distribution", distr->DM_density, distr->Minimum_DM_Speed(), distr->Maximum_DM_Speed()), distribution(distr), relative_accuracy(rel_accuracy)
+{
+	if(relative_accuracy <= 0.0)
+	{
+		std::cerr << "Error in obscura::Tabulated_DM_Distribution::Tabulated_DM_Distribution(): The relative accuracy has to be positive, not " << relative_accuracy << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	DD_use_eta_function = true;
+	Tabulate();
+}
+
+// Bisect [v_1, v_2] until linear interpolation reproduces the pdf at the midpoint.
+void Tabulated_DM_Distribution::Refine_Grid(double v_1, double v_2, double pdf_1, double pdf_2, double pdf_tolerance, unsigned int depth, std::vector<double>& pdf_grid)
+{
+	double v_mid   = (v_1 + v_2) / 2.0;
+	double pdf_mid = distribution->PDF_Speed(v_mid);
+	double error   = std::fabs(pdf_mid - (pdf_1 + pdf_2) / 2.0);
+	if(depth > 0 && error > relative_accuracy * std::fabs(pdf_mid) && error > pdf_tolerance)
+	{
+		Refine_Grid(v_1, v_mid, pdf_1, pdf_mid, pdf_tolerance, depth - 1, pdf_grid);
+		Refine_Grid(v_mid, v_2, pdf_mid, pdf_2, pdf_tolerance, depth - 1, pdf_grid);
+	}
+	else
+	{
+		v_grid.push_back(v_mid);
+		pdf_grid.push_back(pdf_mid);
+		v_grid.push_back(v_2);
+		pdf_grid.push_back(pdf_2);
+	}
+}
+
+void Tabulated_DM_Distribution::Tabulate()
+{
+	// 1. Adaptive grid for the speed pdf, starting from a coarse linear grid
+	unsigned int initial_points	  = 65;
+	unsigned int maximum_depth	  = 16;
+	std::vector<double> v_initial = libphysica::Linear_Space(v_domain[0], v_domain[1], initial_points);
+	std::vector<double> pdf_initial;
+	for(auto& v : v_initial)
+		pdf_initial.push_back(distribution->PDF_Speed(v));
+	// In the tails, the accuracy is relative to the maximum of the pdf.
+	double pdf_tolerance = 1.0e-3 * relative_accuracy * *std::max_element(pdf_initial.begin(), pdf_initial.end());
+
+	v_grid						 = {v_initial.front()};
+	std::vector<double> pdf_grid = {pdf_initial.front()};
+	for(unsigned int i = 0; i < initial_points - 1; i++)
+		Refine_Grid(v_initial[i], v_initial[i + 1], pdf_initial[i], pdf_initial[i + 1], pdf_tolerance, maximum_depth, pdf_grid);
+
+	// 2. Cdf and eta function by trapezoidal integration of the tabulated pdf
+	unsigned int N = v_grid.size();
+	std::vector<double> cdf_grid(N, 0.0), eta_grid(N, 0.0);
+	for(unsigned int i = 1; i < N; i++)
+		cdf_grid[i] = cdf_grid[i - 1] + (v_grid[i] - v_grid[i - 1]) * (pdf_grid[i] + pdf_grid[i - 1]) / 2.0;
+	for(int i = N - 2; i >= 0; i--)
+	{
+		double integrand_1 = (v_grid[i] > 0.0) ? pdf_grid[i] / v_grid[i] : 0.0;
+		double integrand_2 = pdf_grid[i + 1] / v_grid[i + 1];
+		eta_grid[i]		   = eta_grid[i + 1] + (v_grid[i + 1] - v_grid[i]) * (integrand_1 + integrand_2) / 2.0;
+	}
+	pdf_speed	 = libphysica::Interpolation(v_grid, pdf_grid);
+	cdf_speed	 = libphysica::Interpolation(v_grid, cdf_grid);
+	eta_function = libphysica::Interpolation(v_grid, eta_grid);
+}
+
+unsigned int Tabulated_DM_Distribution::Number_Of_Grid_Points() const
+{
+	return v_grid.size();
+}
+
+double Tabulated_DM_Distribution::PDF_Velocity(libphysica::Vector vel) const
+{
+	return distribution->PDF_Velocity(vel);
+}
+
+double Tabulated_DM_Distribution::PDF_Speed(double v) const
+{
+	if(v < v_domain[0] || v > v_domain[1])
+		return 0.0;
+	else
+		return pdf_speed(v);
+}
+
+double Tabulated_DM_Distribution::CDF_Speed(double v) const
+{
+	if(v < v_domain[0])
+		return 0.0;
+	else if(v > v_domain[1])
+		return 1.0;
+	else
+		return cdf_speed(v);
+}
+
+double Tabulated_DM_Distribution::Eta_Function(double vMin) const
+{
+	if(vMin < v_domain[0])
+	{
+		std::cerr << "Error in obscura::Tabulated_DM_Distribution::Eta_Function(): vMin = " << In_Units(vMin, km / sec) << "km/sec lies below the domain [" << In_Units(v_domain[0], km / sec) << "km/sec," << In_Units(v_domain[1], km / sec) << "km/sec]." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(vMin > v_domain[1])
+		return 0.0;
+	else
+		return eta_function(vMin);
+}
+
+void Tabulated_DM_Distribution::Print_Summary(int mpi_rank) const
+{
+	if(mpi_rank == 0)
+	{
+		Print_Summary_Base();
+		std::cout << "\tRelative accuracy:\t" << relative_accuracy << std::endl
+				  << "\tGrid points:\t\t" << v_grid.size() << std::endl
+				  << std::endl;
+	}
+}
+
 }	// namespace obscura
@@ -1,6 +1,15 @@
 #include "obscura/DM_Halo_Models.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
@@ -45,6 +54,7 @@ void Standard_Halo_Model::Set_Speed_Dispersion(double v0)
 {
 	v_0 = v0;
 	Normalize_PDF();
+	Update_Eta_Table();
 }
 void Standard_Halo_Model::Set_Escape_Velocity(double vesc)
 {
@@ -52,6 +62,7 @@ void Standard_Halo_Model::Set_Escape_Velocity(double vesc)
 
 	v_domain[1] = vesc + v_observer;
 	Normalize_PDF();
+	Update_Eta_Table();
 }
 void Standard_Halo_Model::Set_Observer_Velocity(const libphysica::Vector& vel_obs)
 {
@@ -59,6 +70,7 @@ void Standard_Halo_Model::Set_Observer_Velocity(const libphysica::Vector& vel_ob
 	v_observer	 = vel_observer.Norm();
 
 	v_domain[1] = v_esc + v_observer;
+	Update_Eta_Table();
 }
 void Standard_Halo_Model::Set_Observer_Velocity(int day, int month, int year, int hour, int minute)
 {
@@ -67,6 +79,17 @@ void Standard_Halo_Model::Set_Observer_Velocity(int day, int month, int year, in
 	v_observer	  = vel_observer.Norm();
 
 	v_domain[1] = v_esc + v_observer;
+	Update_Eta_Table();
+}
+
+double Standard_Halo_Model::Get_Speed_Dispersion() const
+{
+	return v_0;
+}
+
+double Standard_Halo_Model::Get_Escape_Velocity() const
+{
+	return v_esc;
 }
 
 libphysica::Vector Standard_Halo_Model::Get_Observer_Velocity() const
@@ -74,14 +97,22 @@ libphysica::Vector Standard_Halo_Model::Get_Observer_Velocity() const
 	return vel_observer;
 }
 
+namespace
+{
 //Compute N_esc
+double Normalization_SHM(double v_0, double v_esc)
+{
+	return erf(v_esc / v_0) - 2 * v_esc / v_0 / sqrt(M_PI) * exp(-v_esc * v_esc / v_0 / v_0);
+}
+}	// namespace
+
 void Standard_Halo_Model::Normalize_PDF()
 {
-	N_esc = erf(v_esc / v_0) - 2 * v_esc / v_0 / sqrt(M_PI) * exp(-v_esc * v_esc / v_0 / v_0);
+	N_esc = Normalization_SHM(v_0, v_esc);
 }
 
 //Distribution functions
-double Standard_Halo_Model::PDF_Velocity_SHM(libphysica::Vector vel)
+double Standard_Halo_Model::PDF_Velocity_SHM(libphysica::Vector vel) const
 {
 	double v = vel.Norm();
 	if(v > v_esc || v <= v_domain[0])
@@ -90,7 +121,7 @@ double Standard_Halo_Model::PDF_Velocity_SHM(libphysica::Vector vel)
 		return 1.0 / N_esc * pow(v_0 * sqrt(M_PI), -3.0) * exp(-1.0 * vel * vel / v_0 / v_0);
 }
 
-double Standard_Halo_Model::PDF_Speed_SHM(double v)
+double Standard_Halo_Model::PDF_Speed_SHM(double v) const
 {
 	if(v < v_domain[0] || v > v_domain[1])
 		return 0.0;
@@ -100,7 +131,7 @@ double Standard_Halo_Model::PDF_Speed_SHM(double v)
 		return 4.0 * v * v / N_esc / sqrt(M_PI) / v_0 / v_0 / v_0 * exp(-v * v / v_0 / v_0) * libphysica::StepFunction(Maximum_DM_Speed() - v);
 }
 
-double Standard_Halo_Model::CDF_Speed_SHM(double v)
+double Standard_Halo_Model::CDF_Speed_SHM(double v) const
 {
 	if(v <= v_domain[0])
 		return 0.0;
@@ -117,21 +148,40 @@ double Standard_Halo_Model::CDF_Speed_SHM(double v)
 		return 1.0 / N_esc * (erf(v / v_0) - 2.0 * v / sqrt(M_PI) / v_0 * exp(-v * v / v_0 / v_0));
 }
 
-double Standard_Halo_Model::PDF_Velocity(libphysica::Vector vel)
+double Standard_Halo_Model::PDF_Velocity(libphysica::Vector vel) const
 {
 	return PDF_Velocity_SHM(vel + vel_observer);
 }
-double Standard_Halo_Model::PDF_Speed(double v)
+double Standard_Halo_Model::PDF_Speed(double v) const
 {
 	return PDF_Speed_SHM(v);
 }
-double Standard_Halo_Model::CDF_Speed(double v)
+double Standard_Halo_Model::CDF_Speed(double v) const
 {
 	return CDF_Speed_SHM(v);
 }
 
+// The batch functions call the SHM formulas directly, without a virtual call per speed.
+std::vector<double> Standard_Halo_Model::PDF_Speed(const std::vector<double>& vs) const
+{
+	std::vector<double> pdfs(vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+		pdfs[i] = PDF_Speed_SHM(vs[i]);
+	return pdfs;
+}
+std::vector<double> Standard_Halo_Model::CDF_Speed(const std::vector<double>& vs) const
+{
+	std::vector<double> cdfs(vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+		cdfs[i] = CDF_Speed_SHM(vs[i]);
+	return cdfs;
+}
+
 //Eta-function for direct detection
-double Standard_Halo_Model::Eta_Function_SHM(double vMin)
+namespace
+{
+// Eta function of the SHM for given parameters, shared by Standard_Halo_Model and Halo_Ensemble.
+double SHM_Eta_Function(double vMin, double v_0, double v_esc, double v_observer, double N_esc)
 {
 	double xMin = vMin / v_0;
 	double xEsc = v_esc / v_0;
@@ -149,13 +199,27 @@ double Standard_Halo_Model::Eta_Function_SHM(double vMin)
 	else
 		return 1.0 / v_0 / xE;
 }
+}	// namespace
+
+double Standard_Halo_Model::Eta_Function_SHM(double vMin) const
+{
+	return SHM_Eta_Function(vMin, v_0, v_esc, v_observer, N_esc);
+}
 
-double Standard_Halo_Model::Eta_Function(double vMin)
+double Standard_Halo_Model::Eta_Function(double vMin) const
 {
 	return Eta_Function_SHM(vMin);
 }
 
-void Standard_Halo_Model::Print_Summary_SHM()
+std::vector<double> Standard_Halo_Model::Eta_Function(const std::vector<double>& vMins) const
+{
+	std::vector<double> etas(vMins.size());
+	for(unsigned int i = 0; i < vMins.size(); i++)
+		etas[i] = Eta_Function_SHM(vMins[i]);
+	return etas;
+}
+
+void Standard_Halo_Model::Print_Summary_SHM() const
 {
 	std::cout << "\tSpeed dispersion v_0[km/sec]:\t" << In_Units(v_0, km / sec) << std::endl
 			  << "\tGal. escape velocity [km/sec]:\t" << In_Units(v_esc, km / sec) << std::endl
@@ -164,7 +228,7 @@ void Standard_Halo_Model::Print_Summary_SHM()
 			  << std::endl;
 }
 
-void Standard_Halo_Model::Print_Summary(int mpi_rank)
+void Standard_Halo_Model::Print_Summary(int mpi_rank) const
 {
 	if(mpi_rank == 0)
 	{
@@ -187,7 +251,7 @@ void SHM_Plus_Plus::Normalize_PDF()
 	N_esc_S = erf(v_esc / sqrt(2.0) / sigma_r) - sqrt((1.0 - beta) / beta) * exp(-v_esc * v_esc / 2.0 / sigma_theta / sigma_theta) * libphysica::Erfi(v_esc / sqrt(2.0) / sigma_r * sqrt(beta / (1.0 - beta)));
 }
 
-double SHM_Plus_Plus::PDF_Velocity_S(libphysica::Vector vel)
+double SHM_Plus_Plus::PDF_Velocity_S(libphysica::Vector vel) const
 {
 	double v = vel.Norm();
 	if(v > v_esc)
@@ -201,7 +265,7 @@ double SHM_Plus_Plus::PDF_Velocity_S(libphysica::Vector vel)
 	}
 }
 
-double SHM_Plus_Plus::PDF_Speed_S(double v)
+double SHM_Plus_Plus::PDF_Speed_S(double v) const
 {
 	if(v <= v_domain[0] || v >= v_domain[1])
 		return 0.0;
@@ -212,7 +276,7 @@ double SHM_Plus_Plus::PDF_Speed_S(double v)
 	return libphysica::Integrate_2D(integrand, -1.0, 1.0, 0.0, 2.0 * M_PI);
 }
 
-double SHM_Plus_Plus::CDF_Speed_S(double v)
+double SHM_Plus_Plus::CDF_Speed_S(double v) const
 {
 	if(v <= v_domain[0])
 		return 0.0;
@@ -227,7 +291,7 @@ double SHM_Plus_Plus::CDF_Speed_S(double v)
 	}
 }
 
-double SHM_Plus_Plus::Eta_Function_S(double vMin)
+double SHM_Plus_Plus::Eta_Function_S(double vMin) const
 {
 	if(vMin < v_domain[0] || vMin >= v_domain[1])
 		return 0.0;
@@ -240,16 +304,130 @@ double SHM_Plus_Plus::Eta_Function_S(double vMin)
 	}
 }
 
-void SHM_Plus_Plus::Interpolate_Eta_Function_S(int v_points)
+libphysica::Interpolation SHM_Plus_Plus::Interpolate_Eta_Function_S(int v_points) const
 {
 	std::vector<double> v_list	 = libphysica::Linear_Space(v_domain[0], v_domain[1], v_points);
 	std::vector<double> eta_list = {};
 	for(auto& v : v_list)
 		eta_list.push_back(Eta_Function_S(v));
-	eta_interpolation_s = libphysica::Interpolation(v_list, eta_list);
+	return libphysica::Interpolation(v_list, eta_list);
+}
+
+std::array<double, 6> SHM_Plus_Plus::Eta_Table_S_Parameters() const
+{
+	return {{v_0, v_esc, vel_observer[0], vel_observer[1], vel_observer[2], beta}};
+}
+
+namespace
+{
+std::string eta_table_folder = "";
+std::mutex eta_tables_mutex;
+
+// The file name contains the rounded parameters, the exact ones are listed in the first line.
+std::string Eta_Table_S_File(const std::string& folder, const std::array<double, 6>& parameters, std::string& header)
+{
+	std::ostringstream name, exact;
+	name << "Eta_S";
+	exact << std::setprecision(17) << "#";
+	for(unsigned int i = 0; i < parameters.size(); i++)
+	{
+		double value = (i < 5) ? In_Units(parameters[i], km / sec) : parameters[i];
+		name << "_" << libphysica::Round(value, 6);
+		exact << " " << value;
+	}
+	header = exact.str();
+	return folder + name.str() + ".txt";
+}
+
+bool Import_Eta_Table_S(const std::string& file_path, const std::string& header, libphysica::Interpolation& interpolation)
+{
+	std::ifstream f(file_path);
+	std::string first_line;
+	if(!f || !std::getline(f, first_line) || first_line != header)
+		return false;
+	interpolation = libphysica::Interpolation(libphysica::Import_Table(file_path, {}, 1));
+	return true;
+}
+
+void Export_Eta_Table_S(const std::string& file_path, const std::string& header, const libphysica::Interpolation& interpolation, int v_points)
+{
+	std::ofstream f(file_path);
+	if(!f)
+	{
+		std::cerr << "Warning in obscura::SHM_Plus_Plus::Get_Eta_Table_S(): Could not write the eta table to " << file_path << "." << std::endl;
+		return;
+	}
+	f << header << std::endl
+	  << std::setprecision(17);
+	for(auto& v : libphysica::Linear_Space(interpolation.domain[0], interpolation.domain[1], v_points))
+		f << v << "\t" << interpolation(v) << std::endl;
+}
+}	// namespace
+
+void SHM_Plus_Plus::Set_Eta_Table_Folder(const std::string& folder)
+{
+	std::lock_guard<std::mutex> lock(eta_tables_mutex);
+	eta_table_folder = (folder.empty() || folder.back() == '/') ? folder : folder + "/";
+}
+
+std::shared_ptr<const SHM_Plus_Plus::Eta_Table_S> SHM_Plus_Plus::Get_Eta_Table_S() const
+{
+	std::array<double, 6> parameters		 = Eta_Table_S_Parameters();
+	std::shared_ptr<const Eta_Table_S> table = std::atomic_load(&eta_table_s);
+	if(table != nullptr && table->parameters == parameters)
+		return table;
+
+	// The cache only refers to the tables, which are freed as soon as no SHM++ instance uses them anymore.
+	// A table is built outside of the lock. Other threads, which need the same table, wait for it, all others proceed.
+	static std::map<std::array<double, 6>, std::weak_ptr<const Eta_Table_S>> eta_tables;
+	static std::map<std::array<double, 6>, std::shared_future<std::shared_ptr<const Eta_Table_S>>> pending_eta_tables;
+	std::unique_lock<std::mutex> lock(eta_tables_mutex);
+	auto it = eta_tables.find(parameters);
+	table	= (it == eta_tables.end()) ? nullptr : it->second.lock();
+	if(table == nullptr)
+	{
+		auto pending = pending_eta_tables.find(parameters);
+		if(pending != pending_eta_tables.end())
+		{
+			std::shared_future<std::shared_ptr<const Eta_Table_S>> future = pending->second;
+			lock.unlock();
+			table = future.get();
+		}
+		else
+		{
+			for(auto entry = eta_tables.begin(); entry != eta_tables.end();)
+				entry = entry->second.expired() ? eta_tables.erase(entry) : std::next(entry);
+			std::promise<std::shared_ptr<const Eta_Table_S>> promise;
+			pending_eta_tables[parameters] = promise.get_future().share();
+			std::string folder			   = eta_table_folder;
+			lock.unlock();
+
+			int v_points		   = 100;
+			Eta_Table_S* new_table = new Eta_Table_S;
+			new_table->parameters  = parameters;
+			std::string header, file_path;
+			if(!folder.empty())
+				file_path = Eta_Table_S_File(folder, parameters, header);
+			if(file_path.empty() || !Import_Eta_Table_S(file_path, header, new_table->interpolation))
+			{
+				new_table->interpolation = Interpolate_Eta_Function_S(v_points);
+				if(!file_path.empty())
+					Export_Eta_Table_S(file_path, header, new_table->interpolation, v_points);
+			}
+			table = std::shared_ptr<const Eta_Table_S>(new_table);
+
+			lock.lock();
+			eta_tables[parameters] = table;
+			pending_eta_tables.erase(parameters);
+			lock.unlock();
+			promise.set_value(table);
+		}
+	}
+	std::atomic_store(&eta_table_s, table);
+	return table;
 }
 
-void SHM_Plus_Plus::Print_Summary_SHMpp()
+void SHM_Plus_Plus::Print_Summary_SHMpp() const
 {
 	std::cout << "\tEta parameter:\t" << eta << std::endl
 			  << "\tBeta parameter:\t" << beta << std::endl
@@ -262,7 +440,6 @@ SHM_Plus_Plus::SHM_Plus_Plus(double e, double b)
 	name = "Refined Standard Halo Model (SHM++)";
 	Compute_Sigmas(beta);
 	Normalize_PDF();
-	Interpolate_Eta_Function_S();
 }
 
 SHM_Plus_Plus::SHM_Plus_Plus(double rho, double v0, double vobs, double vesc, double e, double b)
@@ -271,7 +448,6 @@ SHM_Plus_Plus::SHM_Plus_Plus(double rho, double v0, double vobs, double vesc, do
 	name = "Refined Standard Halo Model (SHM++)";
 	Compute_Sigmas(beta);
 	Normalize_PDF();
-	Interpolate_Eta_Function_S();
 }
 
 SHM_Plus_Plus::SHM_Plus_Plus(double rho, double v0, libphysica::Vector& vel_obs, double vesc, double e, double b)
@@ -280,7 +456,6 @@ SHM_Plus_Plus::SHM_Plus_Plus(double rho, double v0, libphysica::Vector& vel_obs,
 	name = "Refined Standard Halo Model (SHM++)";
 	Compute_Sigmas(beta);
 	Normalize_PDF();
-	Interpolate_Eta_Function_S();
 }
 
 void SHM_Plus_Plus::Set_Speed_Dispersion(double v0)
@@ -288,11 +463,13 @@ void SHM_Plus_Plus::Set_Speed_Dispersion(double v0)
 	v_0 = v0;
 	Compute_Sigmas(beta);
 	Normalize_PDF();
+	Update_Eta_Table();
 }
 
 void SHM_Plus_Plus::Set_Eta(double e)
 {
 	eta = e;
+	Update_Eta_Table();
 }
 
 void SHM_Plus_Plus::Set_Beta(double b)
@@ -300,24 +477,25 @@ void SHM_Plus_Plus::Set_Beta(double b)
 	beta = b;
 	Compute_Sigmas(beta);
 	Normalize_PDF();
+	Update_Eta_Table();
 }
 
-double SHM_Plus_Plus::PDF_Velocity(libphysica::Vector vel)
+double SHM_Plus_Plus::PDF_Velocity(libphysica::Vector vel) const
 {
 	return (1.0 - eta) * PDF_Velocity_SHM(vel + vel_observer) + eta * PDF_Velocity_S(vel + vel_observer);
 }
 
-double SHM_Plus_Plus::PDF_Speed(double v)
+double SHM_Plus_Plus::PDF_Speed(double v) const
 {
 	return (1.0 - eta) * PDF_Speed_SHM(v) + eta * PDF_Speed_S(v);
 }
 
-double SHM_Plus_Plus::CDF_Speed(double v)
+double SHM_Plus_Plus::CDF_Speed(double v) const
 {
 	return (1.0 - eta) * CDF_Speed_SHM(v) + eta * CDF_Speed_S(v);
 }
 
-double SHM_Plus_Plus::Eta_Function(double vMin)
+double SHM_Plus_Plus::Eta_Function(double vMin) const
 {
 	if(vMin < v_domain[0])
 	{
@@ -326,11 +504,44 @@ double SHM_Plus_Plus::Eta_Function(double vMin)
 	}
 	else if(vMin > v_domain[1])
 		return 0.0;
+	else if(eta == 0.0)
+		return Eta_Function_SHM(vMin);
 	else
-		return (1.0 - eta) * Eta_Function_SHM(vMin) + eta * eta_interpolation_s(vMin);
+		return (1.0 - eta) * Eta_Function_SHM(vMin) + eta * Get_Eta_Table_S()->interpolation(vMin);
 }
 
-void SHM_Plus_Plus::Print_Summary(int mpi_rank)
+std::vector<double> SHM_Plus_Plus::PDF_Speed(const std::vector<double>& vs) const
+{
+	std::vector<double> pdfs(vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+		pdfs[i] = SHM_Plus_Plus::PDF_Speed(vs[i]);
+	return pdfs;
+}
+
+std::vector<double> SHM_Plus_Plus::CDF_Speed(const std::vector<double>& vs) const
+{
+	std::vector<double> cdfs(vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+		cdfs[i] = SHM_Plus_Plus::CDF_Speed(vs[i]);
+	return cdfs;
+}
+
+std::vector<double> SHM_Plus_Plus::Eta_Function(const std::vector<double>& vMins) const
+{
+	// Look up the table of the sausage component only once.
+	std::shared_ptr<const Eta_Table_S> table = (eta == 0.0) ? nullptr : Get_Eta_Table_S();
+	std::vector<double> etas(vMins.size());
+	for(unsigned int i = 0; i < vMins.size(); i++)
+	{
+		if(table == nullptr || vMins[i] < v_domain[0] || vMins[i] > v_domain[1])
+			etas[i] = SHM_Plus_Plus::Eta_Function(vMins[i]);
+		else
+			etas[i] = (1.0 - eta) * Eta_Function_SHM(vMins[i]) + eta * table->interpolation(vMins[i]);
+	}
+	return etas;
+}
+
+void SHM_Plus_Plus::Print_Summary(int mpi_rank) const
 {
 	if(mpi_rank == 0)
 	{
@@ -340,4 +551,95 @@ void SHM_Plus_Plus::Print_Summary(int mpi_rank)
 	}
 }
 
-}	// namespace obscura
\ No newline at end of file
+// 3. Ensemble of SHM parameter sets
+Halo_Ensemble::Halo_Ensemble()
+{
+}
+
+Halo_Ensemble::Halo_Ensemble(const std::vector<Standard_Halo_Model>& SHMs)
+{
+	for(auto& SHM : SHMs)
+		Add_Member(SHM);
+}
+
+void Halo_Ensemble::Add_Member(double rho, double v0, const libphysica::Vector& vel_obs, double vesc)
+{
+	DM_densities.push_back(rho);
+	v_0s.push_back(v0);
+	v_escs.push_back(vesc);
+	vel_observers.push_back(vel_obs);
+	v_observers.push_back(vel_obs.Norm());
+	N_escs.push_back(Normalization_SHM(v0, vesc));
+	etas_S.push_back(0.0);
+	betas_S.push_back(0.0);
+	eta_tables_S.push_back(nullptr);
+}
+
+void Halo_Ensemble::Add_Member(double rho, double v0, const libphysica::Vector& vel_obs, double vesc, double eta, double beta)
+{
+	libphysica::Vector vel_observer = vel_obs;
+	Add_Member(SHM_Plus_Plus(rho, v0, vel_observer, vesc, eta, beta));
+}
+
+void Halo_Ensemble::Add_Member(const Standard_Halo_Model& SHM)
+{
+	Add_Member(SHM.DM_density, SHM.Get_Speed_Dispersion(), SHM.Get_Observer_Velocity(), SHM.Get_Escape_Velocity());
+	const SHM_Plus_Plus* SHMpp = dynamic_cast<const SHM_Plus_Plus*>(&SHM);
+	if(SHMpp != nullptr)
+	{
+		etas_S.back()		= SHMpp->eta;
+		betas_S.back()		= SHMpp->beta;
+		eta_tables_S.back() = (SHMpp->eta == 0.0) ? nullptr : SHMpp->Get_Eta_Table_S();
+	}
+}
+
+unsigned int Halo_Ensemble::Number_Of_Members() const
+{
+	return v_0s.size();
+}
+
+std::shared_ptr<Standard_Halo_Model> Halo_Ensemble::Member(unsigned int i) const
+{
+	if(i >= Number_Of_Members())
+	{
+		std::cerr << "Error in obscura::Halo_Ensemble::Member(): Index " << i << " out of range for an ensemble of " << Number_Of_Members() << " members." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	libphysica::Vector vel_obs = vel_observers[i];
+	if(etas_S[i] == 0.0 && betas_S[i] == 0.0)
+		return std::make_shared<Standard_Halo_Model>(DM_densities[i], v_0s[i], vel_obs, v_escs[i]);
+	else
+		return std::make_shared<SHM_Plus_Plus>(DM_densities[i], v_0s[i], vel_obs, v_escs[i], etas_S[i], betas_S[i]);
+}
+
+double Halo_Ensemble::DM_Density(unsigned int i) const
+{
+	return DM_densities[i];
+}
+
+double Halo_Ensemble::Maximum_DM_Speed() const
+{
+	double vMax = 0.0;
+	for(unsigned int i = 0; i < Number_Of_Members(); i++)
+		vMax = std::max(vMax, v_escs[i] + v_observers[i]);
+	return vMax;
+}
+
+std::vector<std::vector<double>> Halo_Ensemble::Eta_Functions(const std::vector<double>& vMins) const
+{
+	// The inner loop runs over the members' contiguous parameter arrays.
+	unsigned int N = Number_Of_Members();
+	std::vector<std::vector<double>> etas(vMins.size(), std::vector<double>(N, 0.0));
+	for(unsigned int j = 0; j < vMins.size(); j++)
+	{
+		double* eta = etas[j].data();
+		for(unsigned int i = 0; i < N; i++)
+			eta[i] = SHM_Eta_Function(vMins[j], v_0s[i], v_escs[i], v_observers[i], N_escs[i]);
+		for(unsigned int i = 0; i < N; i++)
+			if(eta_tables_S[i] != nullptr && vMins[j] <= v_escs[i] + v_observers[i])
+				eta[i] = (1.0 - etas_S[i]) * eta[i] + etas_S[i] * eta_tables_S[i]->interpolation(vMins[j]);
+	}
+	return etas;
+}
+
+}	// namespace obscura
@@ -103,13 +103,21 @@ double DM_Particle::dSigma_dER_Nucleus(double ER, const Isotope& target, double
 	return 2.0 * target.mass * dSigma_dq2_Nucleus(q, target, vDM, param);
 }
 
-double DM_Particle::d2Sigma_dER_dEe_Migdal(double ER, double Ee, double vDM, const Isotope& isotope, Atomic_Electron& shell) const
+double DM_Particle::d2Sigma_dER_dEe_Migdal(double ER, double Ee, double vDM, const Isotope& isotope, const Atomic_Electron& shell) const
 {
 	double q  = sqrt(2.0 * isotope.mass * ER);
 	double qe = mElectron / isotope.mass * q;
 	return 1.0 / 4.0 / Ee * dSigma_dER_Nucleus(ER, isotope, vDM) * shell.Ionization_Form_Factor(qe, Ee);
 }
 
+std::vector<double> DM_Particle::d2Sigma_dq2_dEe_Ionization(const std::vector<double>& qs, double Ee, double vDM, const Atomic_Electron& shell) const
+{
+	std::vector<double> cross_sections;
+	for(auto& q : qs)
+		cross_sections.push_back(d2Sigma_dq2_dEe_Ionization(q, Ee, vDM, shell));
+	return cross_sections;
+}
+
 double DM_Particle::Sigma_Total_Nucleus(const Isotope& target, double vDM, double param) const
 {
 	return Sigma_Total_Nucleus_Base(target, vDM, param);
@@ -309,12 +309,21 @@ double DM_Particle_SI::dSigma_dq2_Electron(double q, double vDM, double param) c
 	return sigma_electron / pow(2.0 * libphysica::Reduced_Mass(mass, mElectron) * vDM, 2.0) * FormFactor2_DM(q);
 }
 
-double DM_Particle_SI::d2Sigma_dq2_dEe_Ionization(double q, double Ee, double vDM, Atomic_Electron& shell) const
+double DM_Particle_SI::d2Sigma_dq2_dEe_Ionization(double q, double Ee, double vDM, const Atomic_Electron& shell) const
 {
 	return 1.0 / 4.0 / Ee * dSigma_dq2_Electron(q, vDM) * shell.Ionization_Form_Factor(q, Ee);
 }
 
-double DM_Particle_SI::d2Sigma_dq2_dEe_Crystal(double q, double Ee, double vDM, Crystal& crystal) const
+std::vector<double> DM_Particle_SI::d2Sigma_dq2_dEe_Ionization(const std::vector<double>& qs, double Ee, double vDM, const Atomic_Electron& shell) const
+{
+	// One batched lookup of the ionization form factors
+	std::vector<double> cross_sections = shell.Ionization_Form_Factor(qs, std::vector<double>(qs.size(), Ee));
+	for(unsigned int i = 0; i < qs.size(); i++)
+		cross_sections[i] *= 1.0 / 4.0 / Ee * dSigma_dq2_Electron(qs[i], vDM);
+	return cross_sections;
+}
+
+double DM_Particle_SI::d2Sigma_dq2_dEe_Crystal(double q, double Ee, double vDM, const Crystal& crystal) const
 {
 	return 2.0 * aEM * mElectron * mElectron / q / q / q * dSigma_dq2_Electron(q, vDM) * crystal.Crystal_Form_Factor(q, Ee);
 }
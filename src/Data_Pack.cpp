@@ -0,0 +1,416 @@
+#include "obscura/Data_Pack.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "libphysica/Utilities.hpp"
+
+namespace obscura
+{
+
+//0. Read-only memory mapping
+const std::uint32_t Mapped_File::byte_order_marker = 0x01020304;
+
+Mapped_File::Mapped_File()
+: data(nullptr), size(0)
+{
+}
+
+Mapped_File::~Mapped_File()
+{
+	Unmap();
+}
+
+bool Mapped_File::Map(const std::string& filepath, std::size_t header_size)
+{
+	Unmap();
+	int file_descriptor = open(filepath.c_str(), O_RDONLY);
+	if(file_descriptor < 0)
+		return false;
+	struct stat status;
+	if(fstat(file_descriptor, &status) != 0 || status.st_size < (off_t) header_size)
+	{
+		close(file_descriptor);
+		return false;
+	}
+	void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	close(file_descriptor);
+	if(mapping == MAP_FAILED)
+		return false;
+	data = static_cast<const char*>(mapping);
+	size = status.st_size;
+	return true;
+}
+
+void Mapped_File::Unmap()
+{
+	if(data != nullptr)
+		munmap(const_cast<char*>(data), size);
+	data = nullptr;
+	size = 0;
+}
+
+std::string Mapped_File::Check_Header(const char* magic, std::uint32_t version, const std::string& file_type) const
+{
+	std::uint32_t file_version, file_byte_order;
+	std::memcpy(&file_version, data + 8, 4);
+	std::memcpy(&file_byte_order, data + 12, 4);
+	if(std::memcmp(data, magic, 8) != 0)
+		return "not " + file_type;
+	else if(file_version != version)
+		return "version " + std::to_string(file_version) + " instead of " + std::to_string(version);
+	else if(file_byte_order != byte_order_marker)
+		return "incompatible byte order";
+	else
+		return "";
+}
+
+bool Mapped_File::Is_Mapped() const
+{
+	return data != nullptr;
+}
+
+const char* Mapped_File::Data() const
+{
+	return data;
+}
+
+std::size_t Mapped_File::Size() const
+{
+	return size;
+}
+
+//1. Binary data pack
+const char pack_magic[8]			   = {'O', 'B', 'S', 'C', 'P', 'A', 'C', 'K'};
+const std::uint32_t Data_Pack::version = 1;
+
+// Header: magic, version, byte order, number of tables, index offset, index size, index checksum
+const std::size_t header_size = 8 + 4 + 4 + 4 * 8;
+
+// 64-bit FNV-1a hash
+std::uint64_t Checksum(const char* bytes, std::size_t length)
+{
+	std::uint64_t hash = 14695981039346656037ULL;
+	for(std::size_t i = 0; i < length; i++)
+	{
+		hash ^= static_cast<unsigned char>(bytes[i]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+template <typename T>
+T Read_Binary(const char* bytes)
+{
+	T value;
+	std::memcpy(&value, bytes, sizeof(T));
+	return value;
+}
+
+template <typename T>
+void Write_Binary(std::string& buffer, T value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+bool Source_File_Status(const std::string& filepath, std::uint64_t& file_size, std::uint64_t& file_time)
+{
+	struct stat status;
+	if(stat(filepath.c_str(), &status) != 0)
+		return false;
+	file_size = status.st_size;
+	file_time = status.st_mtime;
+	return true;
+}
+
+std::string Folder(const std::string& filepath)
+{
+	std::size_t position = filepath.find_last_of('/');
+	return (position == std::string::npos) ? "" : filepath.substr(0, position + 1);
+}
+
+Data_Pack::Data_Pack()
+: path("")
+{
+}
+
+Data_Pack::Data_Pack(const std::string& filepath)
+: path(filepath)
+{
+	if(!file.Map(path, header_size))
+		return;
+
+	const char* data			   = file.Data();
+	std::uint64_t number_of_tables = Read_Binary<std::uint64_t>(data + 16);
+	std::uint64_t index_offset	   = Read_Binary<std::uint64_t>(data + 24);
+	std::uint64_t index_size	   = Read_Binary<std::uint64_t>(data + 32);
+	std::uint64_t index_checksum   = Read_Binary<std::uint64_t>(data + 40);
+	std::string problem			   = file.Check_Header(pack_magic, version, "an obscura data pack");
+	if(problem.empty() && (index_offset + index_size != file.Size() || Checksum(data + index_offset, index_size) != index_checksum))
+		problem = "corrupted index";
+	if(problem.empty())
+	{
+		const char* position = data + index_offset;
+		for(std::uint64_t i = 0; i < number_of_tables; i++)
+		{
+			std::uint64_t key_length = Read_Binary<std::uint64_t>(position);
+			std::string key(position + 8, key_length);
+			position += 8 + key_length;
+			Entry entry;
+			entry.offset	  = Read_Binary<std::uint64_t>(position);
+			entry.rows		  = Read_Binary<std::uint64_t>(position + 8);
+			entry.columns	  = Read_Binary<std::uint64_t>(position + 16);
+			entry.checksum	  = Read_Binary<std::uint64_t>(position + 24);
+			entry.source_size = Read_Binary<std::uint64_t>(position + 32);
+			entry.source_time = Read_Binary<std::uint64_t>(position + 40);
+			position += 48;
+			if(entry.offset + 8 * entry.rows * entry.columns > index_offset)
+			{
+				problem = "corrupted index";
+				break;
+			}
+			// The tables are verified once here, such that lookups do not have to hash them again.
+			if(Checksum(data + entry.offset, 8 * entry.rows * entry.columns) != entry.checksum)
+				std::cerr << "Warning in obscura::Data_Pack::Data_Pack(): Checksum mismatch for " << key << " in " << path << ". The text file will be imported instead." << std::endl;
+			else
+				index[key] = entry;
+		}
+	}
+	if(!problem.empty())
+	{
+		std::cerr << "Warning in obscura::Data_Pack::Data_Pack(): Ignoring " << path << " (" << problem << "). The text files will be imported instead." << std::endl;
+		index.clear();
+		file.Unmap();
+	}
+}
+
+bool Data_Pack::Is_Open() const
+{
+	return file.Is_Mapped();
+}
+
+unsigned int Data_Pack::Number_Of_Tables() const
+{
+	return index.size();
+}
+
+std::vector<std::string> Data_Pack::Keys() const
+{
+	std::vector<std::string> keys;
+	for(auto& entry : index)
+		keys.push_back(entry.first);
+	return keys;
+}
+
+const Data_Pack::Entry* Data_Pack::Find_Entry(const std::string& key) const
+{
+	auto it = index.find(key);
+	if(it == index.end())
+		return nullptr;
+	const Entry& entry = it->second;
+
+	// A source file that was modified after the pack was written takes precedence.
+	std::uint64_t source_size, source_time;
+	if(Source_File_Status(Folder(path) + key, source_size, source_time) && (source_size != entry.source_size || source_time != entry.source_time))
+		return nullptr;
+	return &entry;
+}
+
+bool Data_Pack::Contains(const std::string& key) const
+{
+	return Find_Entry(key) != nullptr;
+}
+
+bool Data_Pack::Import_Table(const std::string& key, std::vector<std::vector<double>>& table) const
+{
+	const Entry* entry = Find_Entry(key);
+	if(entry == nullptr)
+		return false;
+	table.assign(entry->rows, std::vector<double>(entry->columns));
+	for(std::uint64_t i = 0; i < entry->rows; i++)
+		std::memcpy(table[i].data(), file.Data() + entry->offset + 8 * i * entry->columns, 8 * entry->columns);
+	return true;
+}
+
+// Parse a text table. Returns false, if the file is not a rectangular numerical table (with an optional label column in every row).
+// Lines starting with '#' are comments.
+bool Parse_Numerical_Table(const std::string& filepath, std::vector<std::vector<double>>& table)
+{
+	std::ifstream f(filepath);
+	if(!f)
+		return false;
+	// Accept all line endings, e.g. Nuclear_Data.txt uses '\r'.
+	std::string content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	std::replace(content.begin(), content.end(), '\r', '\n');
+	std::istringstream content_stream(content);
+	table.clear();
+	bool labeled_rows = false;
+	std::string line;
+	while(std::getline(content_stream, line))
+	{
+		std::istringstream line_stream(line);
+		std::vector<double> row;
+		std::string token;
+		bool first_token = true;
+		bool labeled_row = false;
+		while(line_stream >> token)
+		{
+			if(first_token && token[0] == '#')
+				break;
+			char* end;
+			double value = std::strtod(token.c_str(), &end);
+			if(*end == '\0')
+				row.push_back(value);
+			else if(first_token)
+				labeled_row = true;
+			else
+				return false;
+			first_token = false;
+		}
+		if(first_token)
+			continue;
+		else if(row.empty())
+			return false;
+		if(table.empty())
+			labeled_rows = labeled_row;
+		else if(row.size() != table[0].size() || labeled_row != labeled_rows)
+			return false;
+		table.push_back(row);
+	}
+	return !table.empty();
+}
+
+void Find_Data_Files(const std::string& folder, const std::string& relative_folder, std::vector<std::string>& files)
+{
+	DIR* directory = opendir((folder + relative_folder).c_str());
+	if(directory == nullptr)
+		return;
+	while(struct dirent* item = readdir(directory))
+	{
+		std::string name = item->d_name;
+		if(name == "." || name == "..")
+			continue;
+		std::string relative_path = relative_folder + name;
+		struct stat status;
+		if(stat((folder + relative_path).c_str(), &status) != 0)
+			continue;
+		if(S_ISDIR(status.st_mode))
+			Find_Data_Files(folder, relative_path + "/", files);
+		else if(name.size() > 4 && (name.substr(name.size() - 4) == ".txt" || name.substr(name.size() - 4) == ".dat"))
+			files.push_back(relative_path);
+	}
+	closedir(directory);
+}
+
+unsigned int Create_Data_Pack(const std::string& data_folder, const std::string& pack_path)
+{
+	std::string folder = (data_folder.empty() || data_folder.back() == '/') ? data_folder : data_folder + "/";
+	std::vector<std::string> files;
+	Find_Data_Files(folder, "", files);
+	std::sort(files.begin(), files.end());
+
+	std::string tables, index;
+	unsigned int number_of_tables = 0;
+	for(auto& key : files)
+	{
+		std::vector<std::vector<double>> table;
+		if(!Parse_Numerical_Table(folder + key, table))
+		{
+			std::cout << "\tSkipping " << key << " (no numerical table)." << std::endl;
+			continue;
+		}
+		std::uint64_t source_size = 0, source_time = 0;
+		Source_File_Status(folder + key, source_size, source_time);
+		std::uint64_t offset = header_size + tables.size();
+		std::size_t begin	 = tables.size();
+		for(auto& row : table)
+			for(auto& value : row)
+				Write_Binary<double>(tables, value);
+		Write_Binary<std::uint64_t>(index, key.size());
+		index.append(key);
+		Write_Binary<std::uint64_t>(index, offset);
+		Write_Binary<std::uint64_t>(index, table.size());
+		Write_Binary<std::uint64_t>(index, table[0].size());
+		Write_Binary<std::uint64_t>(index, Checksum(tables.data() + begin, tables.size() - begin));
+		Write_Binary<std::uint64_t>(index, source_size);
+		Write_Binary<std::uint64_t>(index, source_time);
+		number_of_tables++;
+	}
+
+	std::string header(pack_magic, 8);
+	Write_Binary<std::uint32_t>(header, Data_Pack::version);
+	Write_Binary<std::uint32_t>(header, Mapped_File::byte_order_marker);
+	Write_Binary<std::uint64_t>(header, number_of_tables);
+	Write_Binary<std::uint64_t>(header, header_size + tables.size());
+	Write_Binary<std::uint64_t>(header, index.size());
+	Write_Binary<std::uint64_t>(header, Checksum(index.data(), index.size()));
+
+	// Write to a temporary file first, such that processes with an open pack are not affected.
+	std::string temporary_path = pack_path + ".tmp";
+	std::ofstream f(temporary_path, std::ios::binary);
+	if(!f)
+	{
+		std::cerr << "Error in obscura::Create_Data_Pack(): Could not open " << temporary_path << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	f << header << tables << index;
+	f.close();
+	if(!f || std::rename(temporary_path.c_str(), pack_path.c_str()) != 0)
+	{
+		std::cerr << "Error in obscura::Create_Data_Pack(): Could not write " << pack_path << "." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	return number_of_tables;
+}
+
+const Data_Pack& Default_Data_Pack()
+{
+	static const Data_Pack pack(PROJECT_DIR "data/obscura_data.pack");
+	return pack;
+}
+
+//2. Import functions
+bool Import_From_Default_Data_Pack(const std::string& filepath, std::vector<std::vector<double>>& table)
+{
+	const std::string data_folder = PROJECT_DIR "data/";
+	if(filepath.compare(0, data_folder.size(), data_folder) != 0 || !Default_Data_Pack().Is_Open())
+		return false;
+	return Default_Data_Pack().Import_Table(filepath.substr(data_folder.size()), table);
+}
+
+std::vector<std::vector<double>> Import_Data_Table(const std::string& filepath, std::vector<double> dimensions, unsigned int ignored_initial_lines)
+{
+	std::vector<std::vector<double>> table;
+	if(ignored_initial_lines > 0 || !Import_From_Default_Data_Pack(filepath, table))
+		return libphysica::Import_Table(filepath, dimensions, ignored_initial_lines);
+	for(auto& row : table)
+		for(unsigned int j = 0; j < row.size() && j < dimensions.size(); j++)
+			row[j] *= dimensions[j];
+	return table;
+}
+
+std::vector<double> Import_Data_List(const std::string& filepath, double dimension, unsigned int ignored_initial_lines)
+{
+	std::vector<std::vector<double>> table;
+	if(ignored_initial_lines > 0 || !Import_From_Default_Data_Pack(filepath, table))
+		return libphysica::Import_List(filepath, dimension, ignored_initial_lines);
+	std::vector<double> list;
+	for(auto& row : table)
+		for(auto& value : row)
+			list.push_back(dimension * value);
+	return list;
+}
+
+}	// namespace obscura
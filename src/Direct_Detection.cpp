@@ -1,9 +1,18 @@
 #include "obscura/Direct_Detection.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <thread>
+#include <typeinfo>
+
+#include <boost/math/special_functions/gamma.hpp>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
@@ -18,7 +27,7 @@ using namespace libphysica::natural_units;
 // DM Detector base class, which provides the statistical methods and energy bins.
 //Statistics
 //Likelihoods
-double DM_Detector::Log_Likelihood(const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector::Log_Likelihood(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(statistical_analysis == "Poisson")
 	{
@@ -41,6 +50,10 @@ double DM_Detector::Log_Likelihood(const DM_Particle& DM, DM_Distribution& DM_di
 	{
 		return log(P_Value_Maximum_Gap(DM, DM_distr));
 	}
+	else if(statistical_analysis == "Optimum Interval")
+	{
+		return log(P_Value_Optimum_Interval(Maximum_Gap_Expectation_Values(DM, DM_distr)));
+	}
 	else
 	{
 		std::cerr << "Error in obscura::DM_Detector_Nucleus::Log_Likelihood(): Analysis " << statistical_analysis << " not recognized." << std::endl;
@@ -48,83 +61,288 @@ double DM_Detector::Log_Likelihood(const DM_Particle& DM, DM_Distribution& DM_di
 	}
 }
 
-double DM_Detector::Likelihood(const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector::Likelihood(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	return exp(Log_Likelihood(DM, DM_distr));
 }
 
-std::vector<std::vector<double>> DM_Detector::Log_Likelihood_Scan(DM_Particle& DM, DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings)
+std::vector<std::vector<double>> DM_Detector::Log_Likelihood_Scan_Mass(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& couplings) const
 {
-	double m_original		 = DM.mass;
+	// Compute the signals once for a fiducial coupling, and re-scale them for all couplings.
 	double coupling_original = DM.Get_Interaction_Parameter(targets);
+	double fiducial_coupling = *std::max_element(couplings.begin(), couplings.end());
+	int rescaling_power		 = DM.Interaction_Parameter_Is_Cross_Section() ? 1 : 2;
+	DM.Set_Interaction_Parameter(fiducial_coupling, targets);
+	double fiducial_signals = 0.0;
+	std::vector<double> fiducial_spectrum;
+	if(statistical_analysis == "Poisson")
+		fiducial_signals = DM_Signals_Total(DM, DM_distr);
+	else if(statistical_analysis == "Binned Poisson")
+		fiducial_spectrum = DM_Signals_Binned(DM, DM_distr);
+	else if(statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval")
+		fiducial_spectrum = Maximum_Gap_Expectation_Values(DM, DM_distr);
+	else
+	{
+		std::cerr << "Error in obscura::DM_Detector::Log_Likelihood_Scan(): Analysis " << statistical_analysis << " not recognized." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	DM.Set_Interaction_Parameter(coupling_original, targets);
+
 	std::vector<std::vector<double>> log_likelihoods;
-	for(auto& mass : masses)
+	for(auto& coupling : couplings)
 	{
-		DM.Set_Mass(mass);
-		for(auto& coupling : couplings)
+		double rescaling = (fiducial_coupling > 0.0) ? pow(coupling / fiducial_coupling, rescaling_power) : 0.0;
+		double log_likelihood;
+		if(statistical_analysis == "Poisson")
+			log_likelihood = libphysica::Log_Likelihood_Poisson(rescaling * fiducial_signals, observed_events, expected_background);
+		else if(statistical_analysis == "Binned Poisson")
 		{
-			DM.Set_Interaction_Parameter(coupling, targets);
-			log_likelihoods.push_back({mass, coupling, Log_Likelihood(DM, DM_distr)});
+			std::vector<double> expectation_values(fiducial_spectrum.size());
+			for(unsigned int i = 0; i < fiducial_spectrum.size(); i++)
+				expectation_values[i] = rescaling * fiducial_spectrum[i];
+			log_likelihood = libphysica::Log_Likelihood_Poisson_Binned(expectation_values, bin_observed_events, bin_expected_background);
 		}
+		else if(statistical_analysis == "Maximum Gap")
+			log_likelihood = log(P_Value_Maximum_Gap(fiducial_spectrum, rescaling));
+		else
+			log_likelihood = log(P_Value_Optimum_Interval(fiducial_spectrum, rescaling));
+		log_likelihoods.push_back({DM.mass, coupling, log_likelihood});
 	}
-	DM.Set_Mass(m_original);
-	DM.Set_Interaction_Parameter(coupling_original, targets);
 	return log_likelihoods;
 }
 
-double DM_Detector::P_Value(const DM_Particle& DM, DM_Distribution& DM_distr)
+void DM_Detector::Log_Likelihood_Scan(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings, const std::function<void(const std::vector<std::vector<double>>&)>& output, unsigned int threads) const
+{
+	if(couplings.empty())
+		return;
+	if(threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min(threads, (unsigned int) masses.size());
+
+	std::vector<std::unique_ptr<DM_Particle>> DM_copies;
+	for(unsigned int t = 0; threads > 1 && t < threads; t++)
+		DM_copies.emplace_back(DM.Clone());
+	if(threads > 1 && typeid(*DM_copies[0]) != typeid(DM))
+	{
+		std::cerr << "Warning in obscura::DM_Detector::Log_Likelihood_Scan(): Clone() is not overridden for the given DM particle class. Computing the scan with a single thread." << std::endl;
+		threads = 1;
+	}
+
+	if(threads <= 1)
+	{
+		double m_original = DM.mass;
+		for(auto& mass : masses)
+		{
+			DM.Set_Mass(mass);
+			output(Log_Likelihood_Scan_Mass(DM, DM_distr, couplings));
+		}
+		DM.Set_Mass(m_original);
+		return;
+	}
+
+	// Finished masses are passed on to the output as soon as all previous masses are done.
+	std::mutex output_mutex;
+	std::map<unsigned int, std::vector<std::vector<double>>> finished_masses;
+	unsigned int next_output = 0;
+	std::atomic<unsigned int> next_mass(0);
+	auto worker = [&](unsigned int t) {
+		for(unsigned int i = next_mass++; i < masses.size(); i = next_mass++)
+		{
+			DM_copies[t]->Set_Mass(masses[i]);
+			auto rows = Log_Likelihood_Scan_Mass(*DM_copies[t], DM_distr, couplings);
+			std::lock_guard<std::mutex> lock(output_mutex);
+			finished_masses[i] = std::move(rows);
+			for(auto it = finished_masses.find(next_output); it != finished_masses.end(); it = finished_masses.find(++next_output))
+			{
+				output(it->second);
+				finished_masses.erase(it);
+			}
+		}
+	};
+	std::vector<std::thread> pool;
+	for(unsigned int t = 0; t < threads; t++)
+		pool.emplace_back(worker, t);
+	for(auto& thread : pool)
+		thread.join();
+}
+
+std::vector<std::vector<double>> DM_Detector::Log_Likelihood_Scan(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, const std::vector<double>& couplings, unsigned int threads) const
+{
+	std::vector<std::vector<double>> log_likelihoods;
+	auto output = [&log_likelihoods](const std::vector<std::vector<double>>& rows) {
+		log_likelihoods.insert(log_likelihoods.end(), rows.begin(), rows.end());
+	};
+	Log_Likelihood_Scan(DM, DM_distr, masses, couplings, output, threads);
+	return log_likelihoods;
+}
+
+double DM_Detector::P_Value(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	double p_value = 1.0;
 	if(statistical_analysis == "Poisson")
+		p_value = P_Value_Poisson(DM_Signals_Total(DM, DM_distr));
+	else if(statistical_analysis == "Binned Poisson")
+		p_value = P_Value_Binned_Poisson(DM_Signals_Binned(DM, DM_distr));
+	else if(statistical_analysis == "Maximum Gap")
+		p_value = P_Value_Maximum_Gap(DM, DM_distr);
+	else if(statistical_analysis == "Optimum Interval")
+		p_value = P_Value_Optimum_Interval(Maximum_Gap_Expectation_Values(DM, DM_distr));
+	else
 	{
-		double DM_expectation_value;
-		if(using_fiducial_values)
-		{
-			double coupling = DM.Get_Interaction_Parameter(targets);
+		std::cerr << "Error in obscura::DM_Detector_Nucleus::P_Value(): Analysis " << statistical_analysis << " not recognized." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
 
-			int rescaling_power = 2;
-			if(DM.Interaction_Parameter_Is_Cross_Section())
-				rescaling_power = 1;
+	return p_value;
+}
 
-			DM_expectation_value = pow(coupling / fiducial_coupling, rescaling_power) * fiducial_signals;
-		}
+//Halo-independent response matrix
+// Distribution with unit DM density and the eta function (v_k - vMin) / v_max for vMin < v_k, or a step function at v_max.
+// Unlike the narrow basis functions of linear interpolation, these extend over the whole speed range and are resolved by the numerical integrations of the rates.
+class Eta_Ramp_Function : public DM_Distribution
+{
+  private:
+	double v_k;
+	bool step;
+
+  public:
+	Eta_Ramp_Function(double vk, double vmax, bool step_function = false)
+	: DM_Distribution("Eta ramp function", 1.0, 0.0, vmax), v_k(vk), step(step_function)
+	{
+		DD_use_eta_function = true;
+	}
+
+	virtual Eta_Ramp_Function* Clone() const override { return new Eta_Ramp_Function(*this); };
+
+	using DM_Distribution::Eta_Function;
+	virtual double Eta_Function(double vMin) const override
+	{
+		if(vMin > v_domain[1])
+			return 0.0;
+		else if(step)
+			return 1.0;
 		else
-			DM_expectation_value = DM_Signals_Total(DM, DM_distr);
-		p_value = libphysica::CDF_Poisson(DM_expectation_value + expected_background, observed_events);
+			return std::max(v_k - vMin, 0.0) / v_domain[1];
 	}
-	else if(statistical_analysis == "Binned Poisson")
+};
+
+Halo_Response_Matrix DM_Detector::Compute_Halo_Response_Matrix(const DM_Particle& DM, const std::vector<double>& vMin_grid) const
+{
+	if(!DM.DD_use_eta_function)
 	{
-		std::vector<double> expectation_values;
-		if(using_fiducial_values)
+		std::cerr << "Error in obscura::DM_Detector::Compute_Halo_Response_Matrix(): The DM particle does not use the eta function, so the signals are not linear in eta(vMin)." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	else if(vMin_grid.size() < 2 || vMin_grid.front() < 0.0 || !std::is_sorted(vMin_grid.begin(), vMin_grid.end(), std::less_equal<double>()))
+	{
+		std::cerr << "Error in obscura::DM_Detector::Compute_Halo_Response_Matrix(): The vMin grid has to consist of at least 2 strictly increasing, non-negative speeds." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	// The matrix entries are differences of neighbouring ramp responses, which amplifies their integration errors by v_max / delta_v.
+	// The responses are therefore computed by a copy of the detector with a correspondingly tighter accuracy.
+	double delta_v_min = vMin_grid[1] - vMin_grid[0];
+	for(unsigned int k = 1; k < vMin_grid.size() - 1; k++)
+		delta_v_min = std::min(delta_v_min, vMin_grid[k + 1] - vMin_grid[k]);
+	std::unique_ptr<DM_Detector> detector_copy(Clone());
+	if(typeid(*detector_copy) == typeid(*this))
+		detector_copy->Set_Spectrum_Accuracy(spectrum_accuracy * delta_v_min / vMin_grid.back());
+	else
+		std::cerr << "Warning in obscura::DM_Detector::Compute_Halo_Response_Matrix(): Clone() is not overridden for the given detector class. The matrix is computed with the detector's spectrum accuracy." << std::endl;
+	const DM_Detector& detector = (typeid(*detector_copy) == typeid(*this)) ? *detector_copy : *this;
+	if(!detector.Signals_Use_Spectrum_Accuracy())
+		std::cerr << "Warning in obscura::DM_Detector::Compute_Halo_Response_Matrix(): The signals of " << name << " are not integrals of the adaptively sampled spectrum, so the matrix is computed with fixed integration accuracy and its entries can be noisy for fine vMin grids." << std::endl;
+
+	auto signals = [this, &detector, &DM](const DM_Distribution& DM_distr) {
+		if(statistical_analysis == "Poisson")
+			return std::vector<double>({detector.DM_Signals_Total(DM, DM_distr)});
+		else if(statistical_analysis == "Binned Poisson")
+			return detector.DM_Signals_Binned(DM, DM_distr);
+		else if(statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval")
+			return detector.Maximum_Gap_Expectation_Values(DM, DM_distr);
+		else
 		{
-			double coupling		= DM.Get_Interaction_Parameter(targets);
-			int rescaling_power = 2;
-			if(DM.Interaction_Parameter_Is_Cross_Section())
-				rescaling_power = 1;
-			for(unsigned int i = 0; i < fiducial_spectrum.size(); i++)
-				expectation_values.push_back(pow(coupling / fiducial_coupling, rescaling_power) * fiducial_spectrum[i]);
+			std::cerr << "Error in obscura::DM_Detector::Compute_Halo_Response_Matrix(): Analysis " << statistical_analysis << " not recognized." << std::endl;
+			std::exit(EXIT_FAILURE);
 		}
-		else
-			expectation_values = DM_Signals_Binned(DM, DM_distr);
-		std::vector<double> p_values(number_of_bins, 0.0);
-		for(unsigned int i = 0; i < number_of_bins; i++)
+	};
+	// 1. Responses to the ramp functions at each grid point and to the step function.
+	// The linear interpolation of eta with values f_j is sum_k a_k * v_max * ramp_k + f_N * step, where a_k is the change of slope at v_k.
+	unsigned int N = vMin_grid.size();
+	double v_max   = vMin_grid.back();
+	std::vector<std::vector<double>> ramp_responses;
+	for(auto& v_k : vMin_grid)
+		ramp_responses.push_back(signals(Eta_Ramp_Function(v_k, v_max)));
+	std::vector<double> step_response = signals(Eta_Ramp_Function(v_max, v_max, true));
+
+	// 2. Transform to the response to the eta function values on the grid.
+	Halo_Response_Matrix response_matrix;
+	response_matrix.statistical_analysis = statistical_analysis;
+	response_matrix.vMin_grid			 = vMin_grid;
+	response_matrix.matrix				 = std::vector<std::vector<double>>(step_response.size(), std::vector<double>(N, 0.0));
+	for(unsigned int i = 0; i < step_response.size(); i++)
+	{
+		for(unsigned int k = 0; k < N - 1; k++)
 		{
-			double expectation_value = expectation_values[i] + bin_expected_background[i];
-			p_values[i]				 = libphysica::CDF_Poisson(expectation_value, bin_observed_events[i]);
+			double D = v_max * (ramp_responses[k][i] - ramp_responses[k + 1][i]) / (vMin_grid[k + 1] - vMin_grid[k]);
+			response_matrix.matrix[i][k + 1] += D;
+			response_matrix.matrix[i][k] -= D;
 		}
-		p_value = *std::min_element(p_values.begin(), p_values.end());
+		response_matrix.matrix[i][N - 1] += step_response[i];
 	}
-	else if(statistical_analysis == "Maximum Gap")
+	return response_matrix;
+}
+
+std::vector<double> Halo_Response_Matrix::DM_Signals(const DM_Distribution& DM_distr) const
+{
+	if(DM_distr.Maximum_DM_Speed() > vMin_grid.back())
+		std::cerr << "Warning in obscura::Halo_Response_Matrix::DM_Signals(): The DM distribution's maximum speed lies above the vMin grid, the signals are underestimated." << std::endl;
+	// Below the distribution's domain, the eta function is constant.
+	std::vector<double> vMins(vMin_grid);
+	for(auto& vMin : vMins)
+		vMin = std::max(vMin, DM_distr.Minimum_DM_Speed());
+	std::vector<double> etas = DM_distr.Eta_Function(vMins);
+	std::vector<double> signals;
+	for(auto& row : matrix)
+		signals.push_back(DM_distr.DM_density * std::inner_product(row.begin(), row.end(), etas.begin(), 0.0));
+	return signals;
+}
+
+std::vector<std::vector<double>> Halo_Response_Matrix::DM_Signals(const Halo_Ensemble& ensemble) const
+{
+	if(ensemble.Maximum_DM_Speed() > vMin_grid.back())
+		std::cerr << "Warning in obscura::Halo_Response_Matrix::DM_Signals(): The ensemble's maximum speed lies above the vMin grid, the signals are underestimated." << std::endl;
+	unsigned int N = ensemble.Number_Of_Members();
+	std::vector<std::vector<double>> etas = ensemble.Eta_Functions(vMin_grid);
+	std::vector<std::vector<double>> signals(N, std::vector<double>(matrix.size(), 0.0));
+	for(unsigned int r = 0; r < matrix.size(); r++)
 	{
-		p_value = P_Value_Maximum_Gap(DM, DM_distr);
+		// Accumulate over the vMin grid in the same order as for a single distribution, for all members at once.
+		std::vector<double> sums(N, 0.0);
+		for(unsigned int k = 0; k < vMin_grid.size(); k++)
+			for(unsigned int i = 0; i < N; i++)
+				sums[i] += matrix[r][k] * etas[k][i];
+		for(unsigned int i = 0; i < N; i++)
+			signals[i][r] = ensemble.DM_Density(i) * sums[i];
 	}
-	else
+	return signals;
+}
+
+double DM_Detector::Log_Likelihood(const Halo_Response_Matrix& response_matrix, const DM_Distribution& DM_distr) const
+{
+	if(response_matrix.statistical_analysis != statistical_analysis)
 	{
-		std::cerr << "Error in obscura::DM_Detector_Nucleus::P_Value(): Analysis " << statistical_analysis << " not recognized." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector::Log_Likelihood(): The response matrix was computed for the analysis " << response_matrix.statistical_analysis << ", not " << statistical_analysis << "." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
-
-	return p_value;
+	std::vector<double> signals = response_matrix.DM_Signals(DM_distr);
+	if(statistical_analysis == "Poisson")
+		return libphysica::Log_Likelihood_Poisson(signals[0], observed_events, expected_background);
+	else if(statistical_analysis == "Binned Poisson")
+		return libphysica::Log_Likelihood_Poisson_Binned(signals, bin_observed_events, bin_expected_background);
+	else if(statistical_analysis == "Maximum Gap")
+		return log(P_Value_Maximum_Gap(signals));
+	else
+		return log(P_Value_Optimum_Interval(signals));
 }
 
 // (a) Poisson statistics
@@ -148,6 +366,11 @@ void DM_Detector::Set_Observed_Events(unsigned long int n)
 	}
 }
 
+double DM_Detector::P_Value_Poisson(double DM_expectation_value) const
+{
+	return libphysica::CDF_Poisson(DM_expectation_value + expected_background, observed_events);
+}
+
 void DM_Detector::Set_Expected_Background(double B)
 {
 	if(statistical_analysis != "Poisson")
@@ -179,6 +402,17 @@ void DM_Detector::Initialize_Binned_Poisson(unsigned bins)
 	}
 }
 
+double DM_Detector::P_Value_Binned_Poisson(const std::vector<double>& DM_expectation_values) const
+{
+	std::vector<double> p_values(number_of_bins, 0.0);
+	for(unsigned int i = 0; i < number_of_bins; i++)
+	{
+		double expectation_value = DM_expectation_values[i] + bin_expected_background[i];
+		p_values[i]				 = libphysica::CDF_Poisson(expectation_value, bin_observed_events[i]);
+	}
+	return *std::min_element(p_values.begin(), p_values.end());
+}
+
 void DM_Detector::Set_Observed_Events(std::vector<unsigned long int> Ni)
 {
 	if(statistical_analysis != "Binned Poisson")
@@ -246,72 +480,200 @@ void DM_Detector::Use_Maximum_Gap(std::vector<double> energies)
 	energy_max		 = maximum_gap_energy_data.back();
 }
 
+namespace
+{
+// Logarithms of k! for the maximum gap series, tabulated once.
+double Log_Factorial(unsigned int k)
+{
+	static const std::vector<double> table = []() {
+		std::vector<double> log_factorials(1001, 0.0);
+		for(unsigned int i = 1; i < log_factorials.size(); i++)
+			log_factorials[i] = log_factorials[i - 1] + std::log(i);
+		return log_factorials;
+	}();
+	return (k < table.size()) ? table[k] : std::lgamma(k + 1.0);
+}
+
+// For mu > x, C_0(x, mu) = q(mu), where q(t) dt is the probability of an event in [t, t+dt] with all gaps before it below x. It solves
+// q(t) = int_{t-x}^t q(s) exp(s-t) ds with q(t) = 1 for t < x, and the jump q(x) = 1 - exp(-x). Unlike the series, this equation has no cancellations.
+// It is solved on a grid with spacing x/n by the trapezoidal rule for q with exact exponential weights, whose error is O(1/n^2).
+double CDF_Maximum_Gap_Integral_Equation(double x, double mu, unsigned int n)
+{
+	double h	   = x / n;
+	double decay   = std::exp(-h);
+	double decay_x = std::exp(-x);
+	// Weights of q at the lower and upper end of a grid interval.
+	double b = (h - 1.0 + decay) / h;
+	double a = 1.0 - decay - b;
+	std::vector<double> decays(n);
+	for(unsigned int k = 0; k < n; k++)
+		decays[k] = std::exp(-(k * h));
+	// Contributions of the last n grid intervals to the integral, each at the time of its upper end.
+	std::vector<double> window(n, 1.0 - decay);
+	double q	   = 1.0 - decay_x;
+	double q_next  = q;
+	unsigned long int steps = (mu - x) / h;
+	for(unsigned long int i = 0; i <= steps; i++)
+	{
+		// The oldest interval leaves the window and the new one enters.
+		q_next		  = ((decay + a) * q - decay_x * window[i % n]) / (1.0 - b);
+		window[i % n] = a * q + b * q_next;
+		// The running update accumulates rounding errors, so the window is summed up again once per window length.
+		if((i + 1) % n == 0)
+		{
+			q_next = 0.0;
+			for(unsigned int k = 0; k < n; k++)
+				q_next += decays[k] * window[(i + n - k) % n];
+		}
+		if(i < steps)
+			q = q_next;
+	}
+	if(q <= 0.0 || q_next <= 0.0)
+		return 0.0;
+	// q decays exponentially, so it is interpolated linearly in log(q).
+	return q * std::pow(q_next / q, (mu - x - steps * h) / h);
+}
+}	// namespace
+
+// Yellin's C_0(x, mu) = sum_k (kx-mu)^k e^(-kx) / k! (1 + k/(mu-kx)), with the terms evaluated in log space to avoid overflows for large mu.
+// For large mu/x, the alternating terms cancel catastrophically, and C_0 is obtained from an equivalent integral equation instead.
 double CDF_Maximum_Gap(double x, double mu)
 {
 	if(x == mu)
 		return 1.0 - exp(-mu);
+	else if(x <= 0.0)
+		return 0.0;
 	else
 	{
-		int m	   = mu / x;
-		double sum = 0.0;
+		int m				= mu / x;
+		double sum			= 0.0;
+		double absolute_sum = 0.0;
 		for(int k = 0; k <= m; k++)
 		{
-			double term = pow(k * x - mu, k) / libphysica::Factorial(k) * exp(-k * x) * (1.0 + k / (mu - k * x));
+			// (kx-mu)^k (1 + k/(mu-kx)) = (kx-mu)^(k-1) (kx-mu-k), where kx-mu <= 0.
+			double y = k * x - mu;
+			double term;
+			if(y == 0.0)
+				term = (k == 1) ? -exp(-x) : 0.0;
+			else
+			{
+				double log_term = (k - 1) * log(-y) + log(k - y) - k * x - Log_Factorial(k);
+				term			= (k % 2 == 0) ? exp(log_term) : -exp(log_term);
+			}
 			sum += term;
+			absolute_sum += fabs(term);
 			if(fabs(term) < 1e-20)
 				break;
 		}
-		return sum;
+		if(std::numeric_limits<double>::epsilon() * absolute_sum > 1.0e-10 * fabs(sum))
+		{
+			// Richardson extrapolation of the O(1/n^2) error, with the grid coarsened for very large mu/x to bound the run time.
+			unsigned int n = std::max(8.0, std::min(250.0, 1.0e7 * x / mu));
+			sum			   = (4.0 * CDF_Maximum_Gap_Integral_Equation(x, mu, 2 * n) - CDF_Maximum_Gap_Integral_Equation(x, mu, n)) / 3.0;
+		}
+		return std::min(1.0, std::max(0.0, sum));
 	}
 }
 
-double DM_Detector::P_Value_Maximum_Gap(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector::Maximum_Gap_Expectation_Values(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
-	// Interpolate the spectrum
+	// Cumulative integral of the spectrum on a grid, which ends at the kinematic endpoint.
 	unsigned int interpolation_points = 400;
-	std::vector<double> energies;
-	double maximum_energy_deposit = Maximum_Energy_Deposit(DM, DM_distr);
-	if(maximum_energy_deposit < energy_max)
-	{
-		energies = libphysica::Linear_Space(energy_threshold, maximum_energy_deposit, interpolation_points);
-		energies.push_back(energy_max);
-	}
-	else
-		energies = libphysica::Linear_Space(energy_threshold, energy_max, interpolation_points);
-	std::vector<double> spectrum_values;
-	for(auto& energy : energies)
-		spectrum_values.push_back(exposure * dRdE(energy, DM, DM_distr));
-	libphysica::Interpolation spectrum(energies, spectrum_values);
+	std::vector<double> gaps(maximum_gap_energy_data.size() - 1, 0.0);
+	double E_max = std::min(energy_max, Maximum_Energy_Deposit(DM, DM_distr));
+	if(E_max <= energy_threshold)
+		return gaps;
+	std::vector<double> energies		= libphysica::Linear_Space(energy_threshold, E_max, interpolation_points);
+	std::vector<double> spectrum_values = dRdE(energies, DM, DM_distr);
+	std::vector<double> cumulative(energies.size(), 0.0);
+	for(unsigned int i = 1; i < energies.size(); i++)
+		cumulative[i] = cumulative[i - 1] + exposure * (energies[i] - energies[i - 1]) * (spectrum_values[i] + spectrum_values[i - 1]) / 2.0;
+
+	// Read off the cumulative integral at the sorted event energies in one sweep, with the spectrum interpolated linearly.
+	unsigned int k			= 0;
+	auto cumulative_integral = [&energies, &spectrum_values, &cumulative, &k, this](double E) {
+		if(E <= energies.front())
+			return 0.0;
+		else if(E >= energies.back())
+			return cumulative.back();
+		while(energies[k + 1] < E)
+			k++;
+		double dE		  = E - energies[k];
+		double spectrum_E = spectrum_values[k] + dE / (energies[k + 1] - energies[k]) * (spectrum_values[k + 1] - spectrum_values[k]);
+		return cumulative[k] + exposure * dE * (spectrum_values[k] + spectrum_E) / 2.0;
+	};
 
-	//Determine all gaps and find the maximum.
-	std::vector<double> gaps;
-	for(unsigned int i = 0; i < (maximum_gap_energy_data.size() - 1); i++)
+	//Expected number of events in all gaps between the observed events.
+	double C1 = cumulative_integral(maximum_gap_energy_data.front());
+	for(unsigned int i = 0; i < gaps.size(); i++)
 	{
-		double E1  = maximum_gap_energy_data[i];
-		double E2  = maximum_gap_energy_data[i + 1];
-		double gap = spectrum.Integrate(E1, E2);
-		gaps.push_back(gap);
+		double C2 = cumulative_integral(maximum_gap_energy_data[i + 1]);
+		gaps[i]	  = C2 - C1;
+		C1		  = C2;
 	}
+	return gaps;
+}
 
-	double max_gap = *std::max_element(gaps.begin(), gaps.end());
-
-	double N	   = std::accumulate(gaps.begin(), gaps.end(), 0.0);
+// The gaps' expectation values scale linearly with the signal, which allows to re-scale them instead of re-computing the spectrum.
+double DM_Detector::P_Value_Maximum_Gap(const std::vector<double>& gaps, double rescaling) const
+{
+	double max_gap = rescaling * *std::max_element(gaps.begin(), gaps.end());
+	double N	   = rescaling * std::accumulate(gaps.begin(), gaps.end(), 0.0);
 	double p_value = 1.0 - CDF_Maximum_Gap(max_gap, N);
 	return p_value;
 }
 
+double DM_Detector::P_Value_Maximum_Gap(const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	return P_Value_Maximum_Gap(Maximum_Gap_Expectation_Values(DM, DM_distr));
+}
+
+// (d) Optimum interval
+void DM_Detector::Use_Optimum_Interval(std::vector<double> energies, const std::string& table_path)
+{
+	std::shared_ptr<const Optimum_Interval_Table> table = std::make_shared<const Optimum_Interval_Table>(table_path);
+	if(!table->Is_Open())
+	{
+		std::cerr << "Error in obscura::DM_Detector::Use_Optimum_Interval(): The calibration table " << table_path << " could not be opened. It can be generated with ./obscura_optimum_interval." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	Use_Maximum_Gap(energies);
+	statistical_analysis			 = "Optimum Interval";
+	optimum_interval_table			 = table;
+	optimum_interval_fallback_warned = std::make_shared<std::atomic<bool>>(false);
+}
+
+double DM_Detector::P_Value_Optimum_Interval(const std::vector<double>& gaps, double rescaling) const
+{
+	std::vector<double> rescaled_gaps(gaps);
+	for(auto& gap : rescaled_gaps)
+		gap *= rescaling;
+	double mu = std::accumulate(rescaled_gaps.begin(), rescaled_gaps.end(), 0.0);
+	if(!optimum_interval_table->Covers(mu) && !optimum_interval_fallback_warned->exchange(true))
+		std::cerr << "Warning in obscura::DM_Detector::P_Value_Optimum_Interval(): The total expectation value " << mu << " lies outside the calibration table's range [" << optimum_interval_table->Minimum_Mu() << "," << optimum_interval_table->Maximum_Mu() << "]. The maximum gap method is used instead." << std::endl;
+	return optimum_interval_table->P_Value(rescaled_gaps);
+}
+
 void DM_Detector::Set_Flat_Efficiency(double eff)
 {
 	flat_efficiency = eff;
 }
 
-std::string DM_Detector::Target_Particles()
+std::string DM_Detector::Target_Particles() const
 {
 	return targets;
 }
 
 //DM functions
-double DM_Detector::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector::dRdE(const std::vector<double>& energies, const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	std::vector<double> spectrum;
+	for(auto& energy : energies)
+		spectrum.push_back(dRdE(energy, DM, DM_distr));
+	return spectrum;
+}
+
+double DM_Detector::DM_Signals_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	double N = 0;
 	if(statistical_analysis == "Binned Poisson")
@@ -321,28 +683,164 @@ double DM_Detector::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_
 	}
 	else
 	{
-		std::vector<double> args = libphysica::Log_Space(energy_threshold, energy_max, 200);
-		std::vector<double> values;
-		for(auto& arg : args)
+		double error;
+		N = exposure * Integrate_dRdE(energy_threshold, energy_max, DM, DM_distr, error);
+	}
+	return N;
+}
+
+double DM_Detector::Integrate_dRdE(double E_min, double E_max, const DM_Particle& DM, const DM_Distribution& DM_distr, double& error) const
+{
+	error = 0.0;
+	// The spectrum vanishes above the kinematic endpoint.
+	E_max = std::min(E_max, Maximum_Energy_Deposit(DM, DM_distr));
+	if(E_max <= E_min)
+		return 0.0;
+	std::vector<double> energies = (E_min > 0.0) ? libphysica::Log_Space(E_min, E_max, 17) : libphysica::Linear_Space(E_min, E_max, 17);
+	std::vector<double> spectrum;
+	error = Sample_dRdE(energies, spectrum, DM, DM_distr);
+
+	double integral = 0.0;
+	for(unsigned int i = 1; i < energies.size(); i++)
+		integral += (energies[i] - energies[i - 1]) * (spectrum[i] + spectrum[i - 1]) / 2.0;
+	return integral;
+}
+
+void DM_Detector::Set_Spectrum_Accuracy(double relative_accuracy)
+{
+	spectrum_accuracy = relative_accuracy;
+}
+
+double DM_Detector::Sample_dRdE(std::vector<double>& energies, std::vector<double>& spectrum, const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	std::vector<std::vector<double>> spectra;
+	double error = Sample_dRdE({this}, energies, spectra, DM, DM_distr)[0];
+	spectrum	 = spectra[0];
+	return error;
+}
+
+std::vector<double> DM_Detector::Sample_dRdE(const std::vector<const DM_Detector*>& detectors, std::vector<double>& energies, std::vector<std::vector<double>>& spectra, const DM_Particle& DM, const DM_Distribution& DM_distr, bool bin_accuracy)
+{
+	unsigned int number_of_detectors = detectors.size();
+	spectra.clear();
+	for(auto& detector : detectors)
+		spectra.push_back(detector->dRdE(energies, DM, DM_distr));
+	bool log_scale = (energies.front() > 0.0);
+
+	// Error estimates of the intervals [energies[i], energies[i+1]] for each detector
+	std::vector<std::vector<double>> errors(number_of_detectors, std::vector<double>(energies.size() - 1, 0.0));
+	std::vector<bool> converged(energies.size() - 1, false);
+	unsigned int maximum_points = 10000;
+	while(energies.size() < maximum_points)
+	{
+		// The tolerance is distributed over the range, or over each bin, in proportion to the intervals' widths.
+		std::vector<std::vector<double>> tolerances(number_of_detectors, std::vector<double>(converged.size(), 0.0));
+		for(unsigned int d = 0; d < number_of_detectors; d++)
 		{
-			values.push_back(dRdE(arg, DM, DM_distr));
+			std::vector<double> bin_edges = bin_accuracy ? detectors[d]->bin_energies : std::vector<double>({energies.front(), energies.back()});
+			std::vector<int> interval_bins(converged.size(), -1);
+			std::vector<double> bin_integrals(bin_edges.size() - 1, 0.0);
+			for(unsigned int i = 0; i < converged.size(); i++)
+			{
+				int bin = std::upper_bound(bin_edges.begin(), bin_edges.end(), (energies[i] + energies[i + 1]) / 2.0) - bin_edges.begin() - 1;
+				if(bin >= 0 && bin < int(bin_integrals.size()))
+				{
+					interval_bins[i] = bin;
+					bin_integrals[bin] += (energies[i + 1] - energies[i]) * (spectra[d][i] + spectra[d][i + 1]) / 2.0;
+				}
+			}
+			for(unsigned int i = 0; i < converged.size(); i++)
+			{
+				int bin = interval_bins[i];
+				// Intervals outside the detector's bins do not contribute to its signals.
+				if(bin < 0)
+				{
+					tolerances[d][i] = std::numeric_limits<double>::infinity();
+					continue;
+				}
+				double lower = std::max(bin_edges[bin], energies.front());
+				double upper = std::min(bin_edges[bin + 1], energies.back());
+				double width = log_scale ? log(energies[i + 1] / energies[i]) : energies[i + 1] - energies[i];
+				double range = log_scale ? log(upper / lower) : upper - lower;
+				tolerances[d][i] = detectors[d]->spectrum_accuracy * fabs(bin_integrals[bin]) * width / range;
+			}
 		}
-		libphysica::Interpolation interpol(args, values);
-		N = exposure * interpol.Integrate(energy_threshold, energy_max);
+
+		// Bisect the unconverged intervals, evaluating the spectra at all midpoints at once. The number of points is capped at maximum_points.
+		std::vector<double> midpoints;
+		std::vector<bool> bisected(converged.size(), false);
+		unsigned int remaining_points = maximum_points - energies.size();
+		for(unsigned int i = 0; i < converged.size() && midpoints.size() < remaining_points; i++)
+			if(!converged[i])
+			{
+				bisected[i] = true;
+				midpoints.push_back(log_scale ? sqrt(energies[i] * energies[i + 1]) : (energies[i] + energies[i + 1]) / 2.0);
+			}
+		if(midpoints.empty())
+			break;
+		std::vector<std::vector<double>> midpoint_spectra;
+		for(auto& detector : detectors)
+			midpoint_spectra.push_back(detector->dRdE(midpoints, DM, DM_distr));
+
+		std::vector<double> new_energies;
+		std::vector<std::vector<double>> new_spectra(number_of_detectors), new_errors(number_of_detectors);
+		std::vector<bool> new_converged;
+		unsigned int m = 0;
+		for(unsigned int i = 0; i < converged.size(); i++)
+		{
+			new_energies.push_back(energies[i]);
+			for(unsigned int d = 0; d < number_of_detectors; d++)
+				new_spectra[d].push_back(spectra[d][i]);
+			if(!bisected[i])
+			{
+				for(unsigned int d = 0; d < number_of_detectors; d++)
+					new_errors[d].push_back(errors[d][i]);
+				new_converged.push_back(converged[i]);
+				continue;
+			}
+			double a	 = energies[i];
+			double b	 = energies[i + 1];
+			double c				= midpoints[m];
+			bool interval_converged = true;
+			for(unsigned int d = 0; d < number_of_detectors; d++)
+			{
+				double f_c	  = midpoint_spectra[d][m];
+				double coarse = (b - a) * (spectra[d][i] + spectra[d][i + 1]) / 2.0;
+				double fine	  = (c - a) * (spectra[d][i] + f_c) / 2.0 + (b - c) * (f_c + spectra[d][i + 1]) / 2.0;
+				double error  = fabs(fine - coarse) / 3.0;
+				if(error > tolerances[d][i])
+					interval_converged = false;
+				new_spectra[d].push_back(f_c);
+				new_errors[d].insert(new_errors[d].end(), 2, error / 2.0);
+			}
+			m++;
+			new_energies.push_back(c);
+			new_converged.insert(new_converged.end(), 2, interval_converged);
+		}
+		new_energies.push_back(energies.back());
+		for(unsigned int d = 0; d < number_of_detectors; d++)
+			new_spectra[d].push_back(spectra[d].back());
+		energies  = new_energies;
+		spectra	  = new_spectra;
+		errors	  = new_errors;
+		converged = new_converged;
 	}
-	return N;
+	std::vector<double> total_errors;
+	for(auto& detector_errors : errors)
+		total_errors.push_back(std::accumulate(detector_errors.begin(), detector_errors.end(), 0.0));
+	return total_errors;
 }
 
-double DM_Detector::DM_Signal_Rate_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector::DM_Signal_Rate_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	return DM_Signals_Total(DM, DM_distr) / exposure;
 }
 
-std::vector<double> DM_Detector::DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector::DM_Signals_Binned(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(statistical_analysis != "Binned Poisson")
 	{
-		std::cerr << "Error in obscura::DM_Detector::DM_Signals_Binned(const DM_Particle&, DM_Distribution&): The statistical analysis is " << statistical_analysis << ", not 'Binned Poisson'." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector::DM_Signals_Binned(const DM_Particle&, const DM_Distribution&): The statistical analysis is " << statistical_analysis << ", not 'Binned Poisson'." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else if(using_energy_bins)
@@ -355,25 +853,67 @@ std::vector<double> DM_Detector::DM_Signals_Binned(const DM_Particle& DM, DM_Dis
 }
 
 //Limits/Constraints
-double DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, double certainty)
+// Largest factor by which the (binned) signals can be re-scaled with p >= 1-certainty for every bin.
+// The Poisson CDF is inverted exactly via CDF_Poisson(mu, n) = Q(n+1, mu), with Q the regularized upper incomplete gamma function.
+double Maximum_Signal_Rescaling(const std::vector<double>& signals, const std::vector<unsigned long int>& observed_events, const std::vector<double>& expected_background, double certainty)
 {
-	bool found_limit = true;
+	double rescaling = std::numeric_limits<double>::infinity();
+	for(unsigned int i = 0; i < signals.size(); i++)
+	{
+		double mu_max = boost::math::gamma_q_inv(observed_events[i] + 1.0, 1.0 - certainty);
+		if(mu_max <= expected_background[i])
+			return -1.0;
+		else if(signals[i] > 0.0)
+			rescaling = std::min(rescaling, (mu_max - expected_background[i]) / signals[i]);
+	}
+	return std::isinf(rescaling) ? -1.0 : rescaling;
+}
 
+double DM_Detector::Upper_Limit(DM_Particle& DM, const DM_Distribution& DM_distr, double certainty) const
+{
 	double interaction_parameter_original = DM.Get_Interaction_Parameter(targets);
-	if(statistical_analysis == "Binned Poisson" || statistical_analysis == "Poisson")
+
+	// The signals are only computed once for a fiducial coupling and then re-scaled.
+	double fiducial_coupling = interaction_parameter_original;
+	int rescaling_power		 = DM.Interaction_Parameter_Is_Cross_Section() ? 1 : 2;
+
+	// (Binned) Poisson: Direct inversion without root finding
+	if(statistical_analysis == "Poisson" || statistical_analysis == "Binned Poisson")
 	{
-		using_fiducial_values = true;
-		fiducial_coupling	  = interaction_parameter_original;
-		if(statistical_analysis == "Binned Poisson")
-			fiducial_spectrum = DM_Signals_Binned(DM, DM_distr);
+		double rescaling;
+		if(statistical_analysis == "Poisson")
+			rescaling = Maximum_Signal_Rescaling({DM_Signals_Total(DM, DM_distr)}, {observed_events}, {expected_background}, certainty);
 		else
-			fiducial_signals = DM_Signals_Total(DM, DM_distr);
+			rescaling = Maximum_Signal_Rescaling(DM_Signals_Binned(DM, DM_distr), bin_observed_events, bin_expected_background, certainty);
+		if(rescaling <= 0.0)
+			return -1.0;
+		double upper_bound = fiducial_coupling * pow(rescaling, 1.0 / rescaling_power);
+		if(upper_bound < 1.0e-30 || upper_bound > 1.0e10)
+			return -1.0;
+		else
+			return upper_bound;
 	}
+
+	// Maximum gap and optimum interval: Root finding with re-scaled gaps
+	bool found_limit = true;
+	bool using_gaps	 = (statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval");
+	std::vector<double> fiducial_gaps;
+	if(using_gaps)
+		fiducial_gaps = Maximum_Gap_Expectation_Values(DM, DM_distr);
+
 	// Find the interaction parameter such that p = 1-certainty
-	std::function<double(double)> func = [this, &DM, &DM_distr, certainty](double log10_parameter) {
+	std::function<double(double)> func = [this, &DM, &DM_distr, certainty, fiducial_coupling, rescaling_power, using_gaps, &fiducial_gaps](double log10_parameter) {
 		double parameter = pow(10.0, log10_parameter);
-		DM.Set_Interaction_Parameter(parameter, targets);
-		double p_value = P_Value(DM, DM_distr);
+		double p_value;
+		if(statistical_analysis == "Maximum Gap")
+			p_value = P_Value_Maximum_Gap(fiducial_gaps, pow(parameter / fiducial_coupling, rescaling_power));
+		else if(using_gaps)
+			p_value = P_Value_Optimum_Interval(fiducial_gaps, pow(parameter / fiducial_coupling, rescaling_power));
+		else
+		{
+			DM.Set_Interaction_Parameter(parameter, targets);
+			p_value = P_Value(DM, DM_distr);
+		}
 		return p_value - (1.0 - certainty);
 	};
 	double log10_upper_bound;
@@ -383,21 +923,20 @@ double DM_Detector::Upper_Limit(DM_Particle& DM, DM_Distribution& DM_distr, doub
 		log10_upper_bound = libphysica::Find_Root(func, -30.0, 10.0, 1.0e-4);
 
 	DM.Set_Interaction_Parameter(interaction_parameter_original, targets);
-	if(statistical_analysis == "Binned Poisson" || statistical_analysis == "Poisson")
-	{
-		using_fiducial_values = false;
-		fiducial_coupling	  = 0.0;
-		fiducial_signals	  = 0.0;
-		fiducial_spectrum.clear();
-	}
 	if(found_limit)
 		return pow(10.0, log10_upper_bound);
 	else
 		return -1.0;
 }
 
-std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve(DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> masses, double certainty)
+std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve(DM_Particle& DM, const DM_Distribution& DM_distr, std::vector<double> masses, double certainty, unsigned int threads) const
 {
+	if(threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min(threads, (unsigned int) masses.size());
+	if(threads > 1)
+		return Upper_Limit_Curve_Parallel(DM, DM_distr, masses, certainty, threads);
+
 	double mOriginal   = DM.mass;
 	double lowest_mass = Minimum_DM_Mass(DM, DM_distr);
 	std::vector<std::vector<double>> limit;
@@ -415,6 +954,44 @@ std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve(DM_Particle& DM,
 	return limit;
 }
 
+std::vector<std::vector<double>> DM_Detector::Upper_Limit_Curve_Parallel(DM_Particle& DM, const DM_Distribution& DM_distr, const std::vector<double>& masses, double certainty, unsigned int threads) const
+{
+	// The detector and the distribution are shared, but every thread works on its own copy of the particle.
+	std::vector<std::unique_ptr<DM_Particle>> DM_copies;
+	for(unsigned int t = 0; t < threads; t++)
+		DM_copies.emplace_back(DM.Clone());
+	if(typeid(*DM_copies[0]) != typeid(DM))
+	{
+		std::cerr << "Warning in obscura::DM_Detector::Upper_Limit_Curve(): Clone() is not overridden for the given DM particle class. Computing the limits with a single thread." << std::endl;
+		return Upper_Limit_Curve(DM, DM_distr, masses, certainty, 1);
+	}
+
+	double lowest_mass = Minimum_DM_Mass(DM, DM_distr);
+	std::vector<double> upper_limits(masses.size(), -1.0);
+	std::atomic<unsigned int> next_mass(0);
+	auto worker = [&](unsigned int t) {
+		for(unsigned int i = next_mass++; i < masses.size(); i = next_mass++)
+		{
+			if(masses[i] < lowest_mass)
+				continue;
+			DM_copies[t]->Set_Mass(masses[i]);
+			upper_limits[i] = Upper_Limit(*DM_copies[t], DM_distr, certainty);
+		}
+	};
+	std::vector<std::thread> pool;
+	for(unsigned int t = 0; t < threads; t++)
+		pool.emplace_back(worker, t);
+	for(auto& thread : pool)
+		thread.join();
+
+	// Collect the results in the order of the mass list, as in the serial case.
+	std::vector<std::vector<double>> limit;
+	for(unsigned int i = 0; i < masses.size(); i++)
+		if(upper_limits[i] > 0.0)
+			limit.push_back(std::vector<double> {masses[i], upper_limits[i]});
+	return limit;
+}
+
 //Energy spectrum
 void DM_Detector::Use_Energy_Threshold(double Ethr, double Emax)
 {
@@ -443,26 +1020,91 @@ void DM_Detector::Use_Energy_Bins(double Emin, double Emax, int bins)
 	}
 }
 
-std::vector<double> DM_Detector::DM_Signals_Energy_Bins(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector::DM_Signals_Energy_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(!using_energy_bins)
 	{
-		std::cerr << "Error in obscura::DM_Detector::DM_Signals_Energy_Bins(const DM_Particle&,DM_Distribution&): Not using energy bins." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector::DM_Signals_Energy_Bins(const DM_Particle&,const DM_Distribution&): Not using energy bins." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else
+		return DM_Signals_Energy_Bins(std::vector<const DM_Detector*>({this}), DM, DM_distr)[0];
+}
+
+namespace
+{
+// Integrals over the bins from the running trapezoidal sum over the sampled spectrum. Bin edges beyond the last energy, i.e. the kinematic endpoint, receive the full integral.
+std::vector<double> Bin_Integrals(const std::vector<double>& energies, const std::vector<double>& spectrum, const std::vector<double>& bin_edges)
+{
+	std::vector<double> cumulative_integrals(bin_edges.size(), 0.0);
+	unsigned int i			   = 0;
+	double cumulative_integral = 0.0;
+	for(unsigned int edge = 0; edge < bin_edges.size(); edge++)
 	{
-		std::function<double(double)> spectrum = [this, &DM, &DM_distr](double E) {
-			return dRdE(E, DM, DM_distr);
-		};
-		std::vector<double> mu_i;
-		for(unsigned int i = 0; i < number_of_bins; i++)
+		while(i + 1 < energies.size() && energies[i + 1] <= bin_edges[edge])
 		{
-			double mu = exposure * libphysica::Integrate(spectrum, bin_energies[i], bin_energies[i + 1]);
-			mu_i.push_back(bin_efficiencies[i] * mu);
+			cumulative_integral += (energies[i + 1] - energies[i]) * (spectrum[i + 1] + spectrum[i]) / 2.0;
+			i++;
 		}
-		return mu_i;
+		cumulative_integrals[edge] = cumulative_integral;
+	}
+	std::vector<double> integrals;
+	for(unsigned int bin = 0; bin + 1 < bin_edges.size(); bin++)
+		integrals.push_back(cumulative_integrals[bin + 1] - cumulative_integrals[bin]);
+	return integrals;
+}
+}	// namespace
+
+std::vector<std::vector<double>> DM_Detector::DM_Signals_Energy_Bins(const std::vector<const DM_Detector*>& detectors, const DM_Particle& DM, const DM_Distribution& DM_distr)
+{
+	if(detectors.empty())
+		return {};
+	std::vector<double> bin_edges;
+	for(auto& detector : detectors)
+	{
+		if(!detector->using_energy_bins || detector->targets != detectors[0]->targets)
+		{
+			std::cerr << "Error in obscura::DM_Detector::DM_Signals_Energy_Bins(const std::vector<const DM_Detector*>&,const DM_Particle&,const DM_Distribution&): Detector " << detector->name << " does not use energy bins or has different target particles than " << detectors[0]->name << "." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		bin_edges.insert(bin_edges.end(), detector->bin_energies.begin(), detector->bin_energies.end());
+	}
+	std::sort(bin_edges.begin(), bin_edges.end());
+	bin_edges.erase(std::unique(bin_edges.begin(), bin_edges.end()), bin_edges.end());
+
+	// The shared bin edges below the kinematic endpoint are nodes of the sampling, so that no bin edge is evaluated twice.
+	double E_max = 0.0;
+	for(auto& detector : detectors)
+		E_max = std::max(E_max, detector->Maximum_Energy_Deposit(DM, DM_distr));
+	E_max = std::min(E_max, bin_edges.back());
+	std::vector<double> energies;
+	for(unsigned int i = 0; i + 1 < bin_edges.size() && bin_edges[i] < E_max; i++)
+	{
+		double E_next			  = std::min(bin_edges[i + 1], E_max);
+		unsigned int subintervals = std::max(1, 16 / int(bin_edges.size() - 1));
+		for(unsigned int j = 0; j < subintervals; j++)
+			energies.push_back(bin_edges[i] + j * (E_next - bin_edges[i]) / subintervals);
+	}
+	std::vector<std::vector<double>> signals;
+	if(energies.empty())
+	{
+		for(auto& detector : detectors)
+			signals.push_back(std::vector<double>(detector->number_of_bins, 0.0));
+		return signals;
+	}
+	energies.push_back(E_max);
+
+	// The sampling is refined until it has converged for all detectors' spectra, e.g. for different target nuclei or energy resolutions.
+	std::vector<std::vector<double>> spectra;
+	Sample_dRdE(detectors, energies, spectra, DM, DM_distr, true);
+	for(unsigned int d = 0; d < detectors.size(); d++)
+	{
+		std::vector<double> integrals = Bin_Integrals(energies, spectra[d], detectors[d]->bin_energies);
+		for(unsigned int bin = 0; bin < integrals.size(); bin++)
+			integrals[bin] *= detectors[d]->exposure * detectors[d]->bin_efficiencies[bin];
+		signals.push_back(integrals);
 	}
+	return signals;
 }
 
 void DM_Detector::Print_Summary_Base(int MPI_rank) const
@@ -488,7 +1130,7 @@ void DM_Detector::Print_Summary_Base(int MPI_rank) const
 					std::cout << "\t\t" << i + 1 << "\t" << 100.0 * bin_efficiencies[i] << "\t\t" << bin_observed_events[i] << "\t\t" << bin_expected_background[i] << std::endl;
 			}
 		}
-		if(using_energy_threshold || using_energy_bins || statistical_analysis == "Maximum Gap")
+		if(using_energy_threshold || using_energy_bins || statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval")
 			std::cout << "\tRecoil energies [keV]:\t[" << libphysica::Round(energy_threshold / keV) << "," << libphysica::Round(energy_max / keV) << "]" << std::endl;
 		if(using_energy_bins)
 		{
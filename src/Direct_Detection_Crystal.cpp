@@ -1,5 +1,6 @@
 #include "obscura/Direct_Detection_Crystal.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
@@ -24,24 +25,57 @@ unsigned int Electron_Hole_Pairs(double Ee, const Crystal& target)
 	return std::floor((Ee - target.energy_gap) / target.epsilon + 1);
 }
 
-double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal)
+// Range [qi_min, qi_max) of q = (qi+1)*dq, for which vMin(q) < vMax is possible.
+void Kinematic_q_Range(double Ee, double mDM, double vMax, const Crystal& target_crystal, unsigned int& qi_min, unsigned int& qi_max)
+{
+	qi_min			   = 0;
+	qi_max			   = 0;
+	double discriminant = mDM * mDM * vMax * vMax - 2.0 * mDM * Ee;
+	if(discriminant < 0.0)
+		return;
+	double q_min = mDM * vMax - sqrt(discriminant);
+	double q_max = mDM * vMax + sqrt(discriminant);
+	// One grid point of margin on both sides, the exact condition is checked in the loop.
+	qi_min = std::max(0.0, std::floor(q_min / target_crystal.dq) - 2.0);
+	qi_max = std::min<double>(target_crystal.N_q, std::ceil(q_max / target_crystal.dq) + 1.0);
+	if(qi_min > qi_max)
+		qi_min = qi_max;
+}
+
+double dRdEe_Crystal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal)
 {
 	double N_T		= 1.0 / target_crystal.M_cell;
+	double vMax		= DM_distr.Maximum_DM_Speed();
 	double integral = 0.0;
-	for(int qi = 0; qi < 900; qi++)
+	unsigned int qi_min, qi_max;
+	Kinematic_q_Range(Ee, DM.mass, vMax, target_crystal, qi_min, qi_max);
+	if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
 	{
-		double q	= (qi + 1) * target_crystal.dq;
-		double vMin = vMinimal_Electrons(q, Ee, DM.mass);
-		double vMax = DM_distr.Maximum_DM_Speed();
-		if(vMin > vMax)
-			continue;
-		else if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
+		// Evaluate the eta function for all kinematically allowed q in one batch.
+		std::vector<double> qs, vMins;
+		for(unsigned int qi = qi_min; qi < qi_max; qi++)
 		{
-			double vDM = 1e-3;	 //cancels in v^2 * dSigma/dq^2
-			integral += 2.0 * q * target_crystal.dq * DM_distr.DM_density / DM.mass * DM_distr.Eta_Function(vMin) * vDM * vDM * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, vDM, target_crystal);
+			double q	= (qi + 1) * target_crystal.dq;
+			double vMin = vMinimal_Electrons(q, Ee, DM.mass);
+			if(vMin <= vMax)
+			{
+				qs.push_back(q);
+				vMins.push_back(vMin);
+			}
 		}
-		else
+		std::vector<double> etas = DM_distr.Eta_Function_Tabulated(vMins);
+		double vDM				 = 1e-3;   //cancels in v^2 * dSigma/dq^2
+		for(unsigned int i = 0; i < qs.size(); i++)
+			integral += 2.0 * qs[i] * target_crystal.dq * DM_distr.DM_density / DM.mass * etas[i] * vDM * vDM * DM.d2Sigma_dq2_dEe_Crystal(qs[i], Ee, vDM, target_crystal);
+	}
+	else
+	{
+		for(unsigned int qi = qi_min; qi < qi_max; qi++)
 		{
+			double q	= (qi + 1) * target_crystal.dq;
+			double vMin = vMinimal_Electrons(q, Ee, DM.mass);
+			if(vMin > vMax)
+				continue;
 			auto integrand = [&DM_distr, &DM, q, Ee, &target_crystal](double v) {
 				return DM_distr.Differential_DM_Flux(v, DM.mass) * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, v, target_crystal);
 			};
@@ -51,14 +85,90 @@ double dRdEe_Crystal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr
 	return N_T * integral;
 }
 
-double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal)
+std::vector<double> dRdEe_Crystal_Spectrum(const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal)
+{
+	double N_T	= 1.0 / target_crystal.M_cell;
+	double vMax = DM_distr.Maximum_DM_Speed();
+	std::vector<double> spectrum(target_crystal.N_E, 0.0);
+	// q outer, E inner: for fixed q, vMin grows with E, so the E loop ends at the first kinematically forbidden energy.
+	// For each E, the q contributions are summed in the same order as in dRdEe_Crystal().
+	bool use_eta_function = DM.DD_use_eta_function && DM_distr.DD_use_eta_function;
+	std::vector<double> vMins;
+	vMins.reserve(target_crystal.N_E);
+	for(unsigned int qi = 0; qi < target_crystal.N_q; qi++)
+	{
+		double q = (qi + 1) * target_crystal.dq;
+		vMins.clear();
+		for(unsigned int Ei = 0; Ei < target_crystal.N_E; Ei++)
+		{
+			double vMin = vMinimal_Electrons(q, (Ei + 1) * target_crystal.dE, DM.mass);
+			if(vMin > vMax)
+				break;
+			vMins.push_back(vMin);
+		}
+		if(use_eta_function)
+		{
+			std::vector<double> etas = DM_distr.Eta_Function_Tabulated(vMins);
+			double vDM				 = 1e-3;   //cancels in v^2 * dSigma/dq^2
+			for(unsigned int Ei = 0; Ei < vMins.size(); Ei++)
+			{
+				double Ee = (Ei + 1) * target_crystal.dE;
+				spectrum[Ei] += 2.0 * q * target_crystal.dq * DM_distr.DM_density / DM.mass * etas[Ei] * vDM * vDM * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, vDM, target_crystal);
+			}
+		}
+		else
+		{
+			for(unsigned int Ei = 0; Ei < vMins.size(); Ei++)
+			{
+				double Ee	   = (Ei + 1) * target_crystal.dE;
+				auto integrand = [&DM_distr, &DM, q, Ee, &target_crystal](double v) {
+					return DM_distr.Differential_DM_Flux(v, DM.mass) * DM.d2Sigma_dq2_dEe_Crystal(q, Ee, v, target_crystal);
+				};
+				spectrum[Ei] += 2.0 * q * target_crystal.dq * libphysica::Integrate(integrand, vMins[Ei], vMax);
+			}
+		}
+	}
+	for(auto& dRdEe : spectrum)
+		dRdEe *= N_T;
+	return spectrum;
+}
+
+double R_Q_Crystal(int Q, const std::vector<double>& spectrum, const Crystal& target_crystal)
+{
+	//Energy threshold
+	double Emin = Minimum_Electron_Energy(Q, target_crystal);
+	double Emax = Minimum_Electron_Energy(Q + 1, target_crystal);
+	//Sum over the tabulated energies
+	double sum = 0.0;
+	for(unsigned int Ei = (Emin / target_crystal.dE); Ei < spectrum.size(); Ei++)
+	{
+		double E = (Ei + 1) * target_crystal.dE;
+		if(E > Emax)
+			break;
+		sum += target_crystal.dE * spectrum[Ei];
+	}
+	return sum;
+}
+
+double R_total_Crystal(int Qthreshold, const std::vector<double>& spectrum, const Crystal& target_crystal)
+{
+	//Energy threshold
+	double E_min = Minimum_Electron_Energy(Qthreshold, target_crystal);
+	//Sum over the tabulated energies
+	double sum = 0.0;
+	for(unsigned int Ei = (E_min / target_crystal.dE); Ei < spectrum.size(); Ei++)
+		sum += target_crystal.dE * spectrum[Ei];
+	return sum;
+}
+
+double R_Q_Crystal(int Q, const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal)
 {
 	//Energy threshold
 	double Emin = Minimum_Electron_Energy(Q, target_crystal);
 	double Emax = Minimum_Electron_Energy(Q + 1, target_crystal);
 	//Integrate over energies
 	double sum = 0.0;
-	for(int Ei = (Emin / target_crystal.dE); Ei < 500; Ei++)
+	for(unsigned int Ei = (Emin / target_crystal.dE); Ei < target_crystal.N_E; Ei++)
 	{
 		double E = (Ei + 1) * target_crystal.dE;
 		if(E > Emax)
@@ -68,13 +178,13 @@ double R_Q_Crystal(int Q, const DM_Particle& DM, DM_Distribution& DM_distr, Crys
 	return sum;
 }
 
-double R_total_Crystal(int Qthreshold, const DM_Particle& DM, DM_Distribution& DM_distr, Crystal& target_crystal)
+double R_total_Crystal(int Qthreshold, const DM_Particle& DM, const DM_Distribution& DM_distr, const Crystal& target_crystal)
 {
 	//Energy threshold
 	double E_min = Minimum_Electron_Energy(Qthreshold, target_crystal);
 	//Integrate over energies
 	double sum = 0.0;
-	for(int Ei = (E_min / target_crystal.dE); Ei < 500; Ei++)
+	for(unsigned int Ei = (E_min / target_crystal.dE); Ei < target_crystal.N_E; Ei++)
 	{
 		double E = (Ei + 1) * target_crystal.dE;
 		sum += target_crystal.dE * dRdEe_Crystal(E, DM, DM_distr, target_crystal);
@@ -109,12 +219,12 @@ double DM_Detector_Crystal::Minimum_DM_Speed(const DM_Particle& DM) const
 	return sqrt(2.0 * energy_threshold / DM.mass);
 }
 
-double DM_Detector_Crystal::dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector_Crystal::dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	return flat_efficiency * dRdEe_Crystal(E, DM, DM_distr, target_crystal);
 }
 
-double DM_Detector_Crystal::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector_Crystal::DM_Signals_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	double N = 0;
 	if(statistical_analysis == "Binned Poisson")
@@ -122,25 +232,24 @@ double DM_Detector_Crystal::DM_Signals_Total(const DM_Particle& DM, DM_Distribut
 		std::vector<double> binned_events = DM_Signals_Binned(DM, DM_distr);
 		N								  = std::accumulate(binned_events.begin(), binned_events.end(), 0.0);
 	}
-	else if(using_energy_threshold || statistical_analysis == "Maximum Gap")
+	else if(using_energy_threshold || statistical_analysis == "Maximum Gap" || statistical_analysis == "Optimum Interval")
 	{
-		std::function<double(double)> spectrum = [this, &DM, &DM_distr](double E) {
-			return dRdE(E, DM, DM_distr);
-		};
-		N = exposure * libphysica::Integrate(spectrum, energy_threshold, energy_max);
+		double error;
+		N = exposure * Integrate_dRdE(energy_threshold, energy_max, DM, DM_distr, error);
 	}
 	else if(using_Q_threshold)
 	{
-		N = exposure * flat_efficiency * R_total_Crystal(Q_threshold, DM, DM_distr, target_crystal);
+		std::vector<double> spectrum = dRdEe_Crystal_Spectrum(DM, DM_distr, target_crystal);
+		N							 = exposure * flat_efficiency * R_total_Crystal(Q_threshold, spectrum, target_crystal);
 	}
 	return N;
 }
 
-std::vector<double> DM_Detector_Crystal::DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector_Crystal::DM_Signals_Binned(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(statistical_analysis != "Binned Poisson")
 	{
-		std::cerr << "Error in obscura::DM_Detector_Crystal::DM_Signals_Binned(const DM_Particle&, DM_Distribution&): The statistical analysis is " << statistical_analysis << ", not 'Binned Poisson'." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector_Crystal::DM_Signals_Binned(const DM_Particle&, const DM_Distribution&): The statistical analysis is " << statistical_analysis << ", not 'Binned Poisson'." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else if(using_energy_bins)
@@ -180,19 +289,20 @@ void DM_Detector_Crystal::Use_Q_Bins(unsigned int Q_thr, unsigned int N_bins)
 	energy_max		 = Minimum_Electron_Energy(Q_max, target_crystal);
 }
 
-std::vector<double> DM_Detector_Crystal::DM_Signals_Q_Bins(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector_Crystal::DM_Signals_Q_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(!using_Q_bins)
 	{
-		std::cerr << "Error in obscura::DM_Detector_Crystal::DM_Signals_Q_Bins(const DM_Particle&,DM_Distribution&): Not using Q bins." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector_Crystal::DM_Signals_Q_Bins(const DM_Particle&,const DM_Distribution&): Not using Q bins." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else
 	{
+		std::vector<double> spectrum = dRdEe_Crystal_Spectrum(DM, DM_distr, target_crystal);
 		std::vector<double> signals;
 		for(unsigned int Q = Q_threshold; Q < Q_threshold + number_of_bins; Q++)
 		{
-			signals.push_back(exposure * flat_efficiency * bin_efficiencies[Q - 1] * R_Q_Crystal(Q, DM, DM_distr, target_crystal));
+			signals.push_back(exposure * flat_efficiency * bin_efficiencies[Q - 1] * R_Q_Crystal(Q, spectrum, target_crystal));
 		}
 		return signals;
 	}
@@ -10,7 +10,7 @@ namespace obscura
 using namespace libphysica::natural_units;
 
 //1. Event spectra and rates
-double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, double m_nucleus, Atomic_Electron& shell)
+double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, double m_nucleus, const Atomic_Electron& shell)
 {
 	double N_T		= 1.0 / m_nucleus;
 	double vMax		= DM_distr.Maximum_DM_Speed();
@@ -28,17 +28,31 @@ double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM
 	std::vector<double> q_grid = libphysica::Log_Space(qMin, qMax, 100);
 	double d_lnq			   = log(q_grid[1] / q_grid[0]);
 	double integral			   = 0.0;
-	for(auto& q : q_grid)
+	if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
 	{
-		double vMin = vMinimal_Electrons(q, shell.binding_energy + Ee, DM.mass);
-		if(vMin < vMax)
+		// Evaluate the eta function and the cross section for all kinematically allowed q in one batch.
+		std::vector<double> qs, vMins;
+		for(auto& q : q_grid)
 		{
-			if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
+			double vMin = vMinimal_Electrons(q, shell.binding_energy + Ee, DM.mass);
+			if(vMin < vMax)
 			{
-				double vDM = 1.0e-3;   // cancels
-				integral += 2.0 * d_lnq * q * q * DM.d2Sigma_dq2_dEe_Ionization(q, Ee, vDM, shell) * vDM * vDM * DM_distr.DM_density / DM.mass * DM_distr.Eta_Function(vMin);
+				qs.push_back(q);
+				vMins.push_back(vMin);
 			}
-			else
+		}
+		std::vector<double> etas		   = DM_distr.Eta_Function_Tabulated(vMins);
+		double vDM						   = 1.0e-3;   // cancels
+		std::vector<double> cross_sections = DM.d2Sigma_dq2_dEe_Ionization(qs, Ee, vDM, shell);
+		for(unsigned int i = 0; i < qs.size(); i++)
+			integral += 2.0 * d_lnq * qs[i] * qs[i] * cross_sections[i] * vDM * vDM * DM_distr.DM_density / DM.mass * etas[i];
+	}
+	else
+	{
+		for(auto& q : q_grid)
+		{
+			double vMin = vMinimal_Electrons(q, shell.binding_energy + Ee, DM.mass);
+			if(vMin < vMax)
 			{
 				auto integrand = [&DM_distr, &DM, q, Ee, &shell](double v) {
 					return DM_distr.Differential_DM_Flux(v, DM.mass) * DM.d2Sigma_dq2_dEe_Ionization(q, Ee, v, shell);
@@ -50,7 +64,7 @@ double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM
 	return N_T * integral;
 }
 
-double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom)
+double dRdEe_Ionization_ER(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom)
 {
 	double result	 = 0.0;
 	double m_nucleus = atom.nucleus.Average_Nuclear_Mass();
@@ -68,7 +82,7 @@ DM_Detector_Ionization_ER::DM_Detector_Ionization_ER(std::string label, double e
 {
 }
 
-double DM_Detector_Ionization_ER::dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell)
+double DM_Detector_Ionization_ER::dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell) const
 {
 	return flat_efficiency * dRdEe_Ionization_ER(E, DM, DM_distr, nucleus.Average_Nuclear_Mass(), shell);
 }
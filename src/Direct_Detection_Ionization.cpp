@@ -1,6 +1,7 @@
 #include "obscura/Direct_Detection_Ionization.hpp"
 
 #include <cmath>
+#include <numeric>
 
 #include "libphysica/Integration.hpp"
 #include "libphysica/Natural_Units.hpp"
@@ -8,6 +9,8 @@
 #include "libphysica/Statistics.hpp"
 #include "libphysica/Utilities.hpp"
 
+#include "obscura/Data_Pack.hpp"
+
 namespace obscura
 {
 using namespace libphysica::natural_units;
@@ -37,20 +40,21 @@ double DM_Detector_Ionization::Maximum_Energy_Deposit(const DM_Particle& DM, con
 }
 
 //Electron spectrum
-std::vector<double> DM_Detector_Ionization::DM_Signals_Electron_Bins(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector_Ionization::DM_Signals_Electron_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(!using_electron_bins)
 	{
-		std::cerr << "Error in obscura::DM_Detector_Ionization::DM_Signals_Electron_Bins(const DM_Particle&,DM_Distribution&): Not using electron bins." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector_Ionization::DM_Signals_Electron_Bins(const DM_Particle&,const DM_Distribution&): Not using electron bins." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else
 	{
+		std::vector<double> electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr);
 		std::vector<double> signals;
 		for(unsigned int bin = 0; bin < number_of_bins; bin++)
 		{
 			unsigned int ne = ne_threshold + bin;
-			double R_bin	= R_ne(ne, DM, DM_distr);
+			double R_bin	= electron_spectrum[ne - 1];
 			signals.push_back(bin_efficiencies[bin] * exposure * R_bin);
 		}
 		return signals;
@@ -58,43 +62,41 @@ std::vector<double> DM_Detector_Ionization::DM_Signals_Electron_Bins(const DM_Pa
 }
 
 //PE (or S2) spectrum
-double DM_Detector_Ionization::R_S2_Bin(unsigned int S2_1, unsigned int S2_2, const DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> electron_spectrum)
+void DM_Detector_Ionization::Compute_PE_Response_Matrix()
 {
-	double R = 0.0;
-	// Precompute the electron spectrum to speep up the computation of the S2 spectrum
-	if(electron_spectrum.empty())
-		for(unsigned int ne = 1; ne < 16; ne++)
-			electron_spectrum.push_back(R_ne(ne, DM, DM_distr));
-	for(unsigned int PE = S2_1; PE <= S2_2; PE++)
+	unsigned int N_rows = using_S2_bins ? number_of_bins : 1;
+	PE_response_matrix	= std::vector<std::vector<double>>(N_rows, std::vector<double>(ne_max, 0.0));
+	for(unsigned int row = 0; row < N_rows; row++)
 	{
-		double PE_eff = 1.0;
-		if(Trigger_Efficiency_PE.empty() == false)
-			PE_eff *= Trigger_Efficiency_PE[PE - 1];
-		if(Acceptance_Efficiency_PE.empty() == false)
-			PE_eff *= Acceptance_Efficiency_PE[PE - 1];
-		R += PE_eff * R_S2(PE, DM, DM_distr, electron_spectrum);
+		unsigned int PE_1 = using_S2_bins ? S2_bin_ranges[row] : PE_threshold;
+		unsigned int PE_2 = using_S2_bins ? S2_bin_ranges[row + 1] - 1 : PE_max;
+		for(unsigned int PE = PE_1; PE <= PE_2; PE++)
+		{
+			double PE_eff = 1.0;
+			if(Trigger_Efficiency_PE.empty() == false)
+				PE_eff *= Trigger_Efficiency_PE[PE - 1];
+			if(Acceptance_Efficiency_PE.empty() == false)
+				PE_eff *= Acceptance_Efficiency_PE[PE - 1];
+			for(unsigned int ne = 1; ne <= ne_max; ne++)
+				PE_response_matrix[row][ne - 1] += PE_eff * libphysica::PDF_Gauss(PE, S2_mu * ne, sqrt(ne) * S2_sigma);
+		}
 	}
-	return R;
 }
 
-std::vector<double> DM_Detector_Ionization::DM_Signals_PE_Bins(const DM_Particle& DM, DM_Distribution& DM_distr)
+std::vector<double> DM_Detector_Ionization::DM_Signals_PE_Bins(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(!using_S2_bins)
 	{
-		std::cerr << "Error in obscura::DM_Detector_Ionization::DM_Signals_PE_Bins(const DM_Particle&,DM_Distribution&): Not using PE bins." << std::endl;
+		std::cerr << "Error in obscura::DM_Detector_Ionization::DM_Signals_PE_Bins(const DM_Particle&,const DM_Distribution&): Not using PE bins." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
 	else
 	{
-		// Precompute the electron spectrum to speep up the computation of the S2 spectrum
-		std::vector<double> electron_spectrum;
-		for(unsigned int ne = 1; ne < 16; ne++)
-			electron_spectrum.push_back(R_ne(ne, DM, DM_distr));
-
+		std::vector<double> electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr);
 		std::vector<double> signals;
 		for(unsigned int bin = 0; bin < number_of_bins; bin++)
 		{
-			double R_bin = R_S2_Bin(S2_bin_ranges[bin], S2_bin_ranges[bin + 1] - 1, DM, DM_distr, electron_spectrum);
+			double R_bin = std::inner_product(electron_spectrum.begin(), electron_spectrum.end(), PE_response_matrix[bin].begin(), 0.0);
 			signals.push_back(bin_efficiencies[bin] * exposure * R_bin);
 		}
 		return signals;
@@ -146,7 +148,7 @@ double DM_Detector_Ionization::Minimum_DM_Speed(const DM_Particle& DM) const
 	return sqrt(2.0 * Energy_Gap() / DM.mass);
 }
 
-double DM_Detector_Ionization::dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector_Ionization::dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	double dRdE = 0.0;
 	for(auto i = 0; i < atomic_targets.size(); i++)
@@ -154,7 +156,7 @@ double DM_Detector_Ionization::dRdE(double E, const DM_Particle& DM, DM_Distribu
 	return dRdE;
 }
 
-double DM_Detector_Ionization::DM_Signals_Total(const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector_Ionization::DM_Signals_Total(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	double N = 0;
 
@@ -164,8 +166,11 @@ double DM_Detector_Ionization::DM_Signals_Total(const DM_Particle& DM, DM_Distri
 		N								  = std::accumulate(binned_events.begin(), binned_events.end(), 0.0);
 	}
 	else if(using_electron_threshold)
+	{
+		std::vector<double> electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr);
 		for(unsigned int ne = ne_threshold; ne <= ne_max; ne++)
-			N += exposure * R_ne(ne, DM, DM_distr);
+			N += exposure * electron_spectrum[ne - 1];
+	}
 	else if(using_energy_threshold)
 		for(auto i = 0; i < atomic_targets.size(); i++)
 			for(auto& electron : atomic_targets[i].electrons)
@@ -181,12 +186,25 @@ double DM_Detector_Ionization::DM_Signals_Total(const DM_Particle& DM, DM_Distri
 				}
 			}
 	else if(using_S2_threshold)
-		N = exposure * R_S2_Bin(PE_threshold, PE_max, DM, DM_distr);
+	{
+		std::vector<double> electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr);
+		N									  = exposure * std::inner_product(electron_spectrum.begin(), electron_spectrum.end(), PE_response_matrix[0].begin(), 0.0);
+	}
 
 	return N;
 }
 
-std::vector<double> DM_Detector_Ionization::DM_Signals_Binned(const DM_Particle& DM, DM_Distribution& DM_distr)
+bool DM_Detector_Ionization::Signals_Use_Spectrum_Accuracy() const
+{
+	if(statistical_analysis == "Binned Poisson")
+		return using_energy_bins;
+	else if(statistical_analysis == "Poisson")
+		return !using_electron_threshold && !using_energy_threshold && !using_S2_threshold;
+	else
+		return true;
+}
+
+std::vector<double> DM_Detector_Ionization::DM_Signals_Binned(const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	if(statistical_analysis != "Binned Poisson")
 	{
@@ -213,12 +231,12 @@ std::vector<double> DM_Detector_Ionization::DM_Signals_Binned(const DM_Particle&
 }
 
 //Energy spectrum
-double DM_Detector_Ionization::dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell)
+double DM_Detector_Ionization::dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell) const
 {
 	return 0.0;
 }
 
-double DM_Detector_Ionization::dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom)
+double DM_Detector_Ionization::dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom) const
 {
 	double dRdE = 0.0;
 	for(auto& electron : atom.electrons)
@@ -237,18 +255,18 @@ double PDF_ne(unsigned int ne, double Ee, double W, int n_secondary)
 	return libphysica::PMF_Binomial(neMax, fe, ne - 1);
 }
 
-double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr, double W, const Nucleus& nucleus, Atomic_Electron& shell)
+double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, const DM_Distribution& DM_distr, double W, const Nucleus& nucleus, const Atomic_Electron& shell) const
 {
 	double R = 0.0;
-	for(auto& k : shell.k_Grid)
+	for(auto& k : shell.k_Grid())
 	{
 		double Ee = k * k / 2.0 / mElectron;
-		R += log(10.0) * shell.dlogk * k * k / mElectron * PDF_ne(ne, Ee, W, shell.number_of_secondary_electrons) * dRdE_Ionization(Ee, DM, DM_distr, nucleus, shell);
+		R += log(10.0) * shell.dlogk * k * k / mElectron * dRdE_Ionization(Ee, DM, DM_distr, nucleus, shell) * PDF_ne(ne, Ee, W, shell.number_of_secondary_electrons);
 	}
 	return R;
 }
 
-double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom)
+double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom) const
 {
 	double R = 0.0;
 	for(auto& electron : atom.electrons)
@@ -256,7 +274,7 @@ double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, DM_D
 	return R;
 }
 
-double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
 	double R = 0.0;
 	for(auto i = 0; i < atomic_targets.size(); i++)
@@ -265,6 +283,46 @@ double DM_Detector_Ionization::R_ne(unsigned int ne, const DM_Particle& DM, DM_D
 	return R;
 }
 
+std::vector<double> DM_Detector_Ionization::Electron_Spectrum(unsigned int ne_maximum, const DM_Particle& DM, const DM_Distribution& DM_distr, double W, const Nucleus& nucleus, const Atomic_Electron& shell) const
+{
+	// The ionization spectrum is evaluated only once per k and then distributed over all ne.
+	std::vector<double> spectrum(ne_maximum, 0.0);
+	for(auto& k : shell.k_Grid())
+	{
+		double Ee	= k * k / 2.0 / mElectron;
+		double dRdE = log(10.0) * shell.dlogk * k * k / mElectron * dRdE_Ionization(Ee, DM, DM_distr, nucleus, shell);
+		if(dRdE == 0.0)
+			continue;
+		for(unsigned int ne = 1; ne <= ne_maximum; ne++)
+			spectrum[ne - 1] += dRdE * PDF_ne(ne, Ee, W, shell.number_of_secondary_electrons);
+	}
+	return spectrum;
+}
+
+std::vector<double> DM_Detector_Ionization::Electron_Spectrum(unsigned int ne_maximum, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom) const
+{
+	std::vector<double> spectrum(ne_maximum, 0.0);
+	for(auto& electron : atom.electrons)
+	{
+		std::vector<double> spectrum_shell = Electron_Spectrum(ne_maximum, DM, DM_distr, atom.W, atom.nucleus, electron);
+		for(unsigned int i = 0; i < ne_maximum; i++)
+			spectrum[i] += spectrum_shell[i];
+	}
+	return spectrum;
+}
+
+std::vector<double> DM_Detector_Ionization::Electron_Spectrum(unsigned int ne_maximum, const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	std::vector<double> spectrum(ne_maximum, 0.0);
+	for(unsigned int i = 0; i < atomic_targets.size(); i++)
+	{
+		std::vector<double> spectrum_atom = Electron_Spectrum(ne_maximum, DM, DM_distr, atomic_targets[i]);
+		for(unsigned int j = 0; j < ne_maximum; j++)
+			spectrum[j] += relative_mass_fractions[i] * spectrum_atom[j];
+	}
+	return spectrum;
+}
+
 void DM_Detector_Ionization::Use_Electron_Threshold(unsigned int ne_thr, unsigned int nemax)
 {
 	Initialize_Poisson();
@@ -296,39 +354,36 @@ void DM_Detector_Ionization::Use_Electron_Bins(unsigned int ne_thr, unsigned int
 }
 
 //PE (or S2) spectrum
-double R_S2_aux(unsigned int nPE, double mu_PE, double sigma_PE, std::vector<double> R_ne_spectrum)
+double R_S2_aux(unsigned int nPE, double mu_PE, double sigma_PE, const std::vector<double>& R_ne_spectrum)
 {
 	double sum = 0.0;
-	for(int ne = 1; ne < 16; ne++)
+	for(unsigned int ne = 1; ne <= R_ne_spectrum.size(); ne++)
 		sum += libphysica::PDF_Gauss(nPE, mu_PE * ne, sqrt(ne) * sigma_PE) * R_ne_spectrum[ne - 1];
 	return sum;
 }
 
-double DM_Detector_Ionization::R_S2(unsigned int S2, const DM_Particle& DM, DM_Distribution& DM_distr, double W, const Nucleus& nucleus, Atomic_Electron& shell, std::vector<double> electron_spectrum)
+double DM_Detector_Ionization::R_S2(unsigned int S2, const DM_Particle& DM, const DM_Distribution& DM_distr, double W, const Nucleus& nucleus, const Atomic_Electron& shell, std::vector<double> electron_spectrum) const
 {
 	if(electron_spectrum.empty())
-		for(unsigned ne = 1; ne < 16; ne++)
-			electron_spectrum.push_back(R_ne(ne, DM, DM_distr, W, nucleus, shell));
+		electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr, W, nucleus, shell);
 	return R_S2_aux(S2, S2_mu, S2_sigma, electron_spectrum);
 }
 
-double DM_Detector_Ionization::R_S2(unsigned int S2, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom, std::vector<double> electron_spectrum)
+double DM_Detector_Ionization::R_S2(unsigned int S2, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom, std::vector<double> electron_spectrum) const
 {
 	if(electron_spectrum.empty())
-		for(unsigned ne = 1; ne < 16; ne++)
-			electron_spectrum.push_back(R_ne(ne, DM, DM_distr, atom));
+		electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr, atom);
 	return R_S2_aux(S2, S2_mu, S2_sigma, electron_spectrum);
 }
 
-double DM_Detector_Ionization::R_S2(unsigned int S2, const DM_Particle& DM, DM_Distribution& DM_distr, std::vector<double> electron_spectrum)
+double DM_Detector_Ionization::R_S2(unsigned int S2, const DM_Particle& DM, const DM_Distribution& DM_distr, std::vector<double> electron_spectrum) const
 {
 	if(electron_spectrum.empty())
-		for(unsigned ne = 1; ne < 16; ne++)
-			electron_spectrum.push_back(R_ne(ne, DM, DM_distr));
+		electron_spectrum = Electron_Spectrum(ne_max, DM, DM_distr);
 	return R_S2_aux(S2, S2_mu, S2_sigma, electron_spectrum);
 }
 
-void DM_Detector_Ionization::Use_PE_Threshold(double S2mu, double S2sigma, unsigned int nPE_thr, unsigned int nPE_max)
+void DM_Detector_Ionization::Use_PE_Threshold(double S2mu, double S2sigma, unsigned int nPE_thr, unsigned int nPE_max, unsigned int nemax)
 {
 	Initialize_Poisson();
 	using_S2_threshold		 = true;
@@ -345,6 +400,8 @@ void DM_Detector_Ionization::Use_PE_Threshold(double S2mu, double S2sigma, unsig
 		std::cerr << "Error in obscura::DM_Detector::Use_PE_Threshold(): PE threshold (" << PE_threshold << ") is higher than maximum (" << PE_max << ")." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+	ne_max = nemax;
+	Compute_PE_Response_Matrix();
 }
 
 void DM_Detector_Ionization::Import_Trigger_Efficiency_PE(std::string filename)
@@ -356,7 +413,8 @@ void DM_Detector_Ionization::Import_Trigger_Efficiency_PE(std::string filename)
 	}
 	else
 	{
-		Trigger_Efficiency_PE = libphysica::Import_List(filename);
+		Trigger_Efficiency_PE = Import_Data_List(filename);
+		Compute_PE_Response_Matrix();
 	}
 }
 
@@ -369,12 +427,13 @@ void DM_Detector_Ionization::Import_Acceptance_Efficiency_PE(std::string filenam
 	}
 	else
 	{
-		Acceptance_Efficiency_PE = libphysica::Import_List(filename);
+		Acceptance_Efficiency_PE = Import_Data_List(filename);
+		Compute_PE_Response_Matrix();
 	}
 }
 
 //Binned Poisson:  PE bins (S2)
-void DM_Detector_Ionization::Use_PE_Bins(double S2mu, double S2sigma, const std::vector<unsigned int>& bin_ranges)
+void DM_Detector_Ionization::Use_PE_Bins(double S2mu, double S2sigma, const std::vector<unsigned int>& bin_ranges, unsigned int nemax)
 {
 	Initialize_Binned_Poisson(bin_ranges.size() - 1);
 	using_S2_bins = true;
@@ -382,6 +441,8 @@ void DM_Detector_Ionization::Use_PE_Bins(double S2mu, double S2sigma, const std:
 	S2_mu		  = S2mu;
 	S2_sigma	  = S2sigma;
 	S2_bin_ranges = bin_ranges;
+	ne_max		  = nemax;
+	Compute_PE_Response_Matrix();
 }
 
 void DM_Detector_Ionization::Print_Summary(int MPI_rank) const
@@ -398,6 +459,7 @@ void DM_Detector_Ionization::Print_Summary(int MPI_rank) const
 	{
 		std::cout << "\tmu_PE:\t\t" << S2_mu << std::endl
 				  << "\tsigma_PE:\t" << S2_sigma << std::endl
+				  << "\tNe max:\t\t" << ne_max << std::endl
 				  << "\tImported trigger efficiencies:\t" << (Trigger_Efficiency_PE.empty() ? "[ ]" : "[x]") << std::endl
 				  << "\tImported acc. efficiencies:\t" << (Acceptance_Efficiency_PE.empty() ? "[ ]" : "[x]") << std::endl;
 		if(using_S2_bins)
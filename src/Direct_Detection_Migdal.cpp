@@ -16,7 +16,7 @@ double vMinimal_Migdal(double ER, double Ee, double mDM, double mN)
 	return sqrt(mN * ER / 2.0 / mu / mu) + Ee / sqrt(2.0 * mN * ER);
 }
 
-double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& isotope, Atomic_Electron& shell)
+double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Isotope& isotope, const Atomic_Electron& shell)
 {
 	double NT = 1.0 / isotope.mass;
 
@@ -27,7 +27,7 @@ double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution
 		if(DM.DD_use_eta_function && DM_distr.DD_use_eta_function)
 		{
 			double vDM = 1.0e-3;   // cancels
-			return DM_distr.DM_density / DM.mass * DM_distr.Eta_Function(vMin) * DM.d2Sigma_dER_dEe_Migdal(ER, Ee, vDM, isotope, shell) * vDM * vDM;
+			return DM_distr.DM_density / DM.mass * DM_distr.Eta_Function_Tabulated(vMin) * DM.d2Sigma_dER_dEe_Migdal(ER, Ee, vDM, isotope, shell) * vDM * vDM;
 		}
 		else
 		{
@@ -49,7 +49,7 @@ double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution
 	return NT * libphysica::Integrate(ER_integrand, ER_min, ER_max);
 }
 
-extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell)
+extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell)
 {
 	double result = 0.0;
 	for(auto& isotope : nucleus.isotopes)
@@ -57,7 +57,7 @@ extern double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distr
 	return result;
 }
 
-double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, DM_Distribution& DM_distr, Atom& atom)
+double dRdEe_Ionization_Migdal(double Ee, const DM_Particle& DM, const DM_Distribution& DM_distr, const Atom& atom)
 {
 	double result = 0.0;
 	for(auto& electron : atom.electrons)
@@ -72,7 +72,7 @@ DM_Detector_Ionization_Migdal::DM_Detector_Ionization_Migdal(std::string label,
 DM_Detector_Ionization_Migdal::DM_Detector_Ionization_Migdal(std::string label, double expo, std::vector<std::string> atoms, std::vector<double> mass_fractions)
 : DM_Detector_Ionization(label, expo, "Nuclei", atoms, mass_fractions) {}
 
-double DM_Detector_Ionization_Migdal::dRdE_Ionization(double E, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& nucleus, Atomic_Electron& shell)
+double DM_Detector_Ionization_Migdal::dRdE_Ionization(double E, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& nucleus, const Atomic_Electron& shell) const
 {
 	return flat_efficiency * dRdEe_Ionization_Migdal(E, DM, DM_distr, nucleus, shell);
 }
@@ -2,18 +2,20 @@
 
 #include <algorithm>   //for std::min_element, std::max_element, std::sort
 #include <cmath>
-#include <numeric>	 //for std::accumulate
+#include <numeric>	 //for std::accumulate, std::inner_product
 
 #include "libphysica/Special_Functions.hpp"
 #include "libphysica/Statistics.hpp"
 #include "libphysica/Utilities.hpp"
 
+#include "obscura/Data_Pack.hpp"
+
 namespace obscura
 {
 using namespace libphysica::natural_units;
 
 //1. Theoretical nuclear recoil spectrum
-double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Isotope& target_isotope)
+double dRdER_Nucleus(double ER, const DM_Particle& DM, const DM_Distribution& DM_distr, const Isotope& target_isotope)
 {
 	double vMin = vMinimal_Nucleus(ER, DM.mass, target_isotope.mass);
 	double vMax = DM_distr.Maximum_DM_Speed();
@@ -23,7 +25,7 @@ double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr
 	{
 		double rhoDM = DM_distr.DM_density * DM.fractional_density;
 		double vDM	 = 1.0e-3;	 //cancels when eta function can be used
-		return 1.0 / target_isotope.mass * rhoDM / DM.mass * (vDM * vDM * DM.dSigma_dER_Nucleus(ER, target_isotope, vDM)) * DM_distr.Eta_Function(vMin);
+		return 1.0 / target_isotope.mass * rhoDM / DM.mass * (vDM * vDM * DM.dSigma_dER_Nucleus(ER, target_isotope, vDM)) * DM_distr.Eta_Function_Tabulated(vMin);
 	}
 	else
 	{
@@ -35,7 +37,7 @@ double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr
 	}
 }
 
-double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr, const Nucleus& target_nucleus)
+double dRdER_Nucleus(double ER, const DM_Particle& DM, const DM_Distribution& DM_distr, const Nucleus& target_nucleus)
 {
 	double dRate = 0.0;
 	for(unsigned int i = 0; i < target_nucleus.Number_of_Isotopes(); i++)
@@ -49,6 +51,7 @@ double dRdER_Nucleus(double ER, const DM_Particle& DM, DM_Distribution& DM_distr
 DM_Detector_Nucleus::DM_Detector_Nucleus()
 : DM_Detector("Nuclear recoil experiment", kg * day, "Nuclei"), target_nuclei({Get_Nucleus(54)}), relative_mass_fractions({1.0}), energy_resolution(0.0), using_efficiency_tables(false)
 {
+	Tabulate_Isotopes();
 }
 
 DM_Detector_Nucleus::DM_Detector_Nucleus(std::string label, double expo, std::vector<Nucleus> nuclei, std::vector<double> abund)
@@ -70,6 +73,72 @@ DM_Detector_Nucleus::DM_Detector_Nucleus(std::string label, double expo, std::ve
 	}
 	else
 		relative_mass_fractions = abund;
+	Tabulate_Isotopes();
+}
+
+void DM_Detector_Nucleus::Tabulate_Isotopes()
+{
+	isotope_table = Isotope_Table();
+	for(unsigned int i = 0; i < target_nuclei.size(); i++)
+	{
+		for(unsigned int j = 0; j < target_nuclei[i].Number_of_Isotopes(); j++)
+		{
+			isotope_table.masses.push_back(target_nuclei[i][j].mass);
+			isotope_table.weights.push_back(relative_mass_fractions[i] * target_nuclei[i][j].abundance);
+			isotope_table.nuclei.push_back(i);
+			isotope_table.isotopes.push_back(j);
+		}
+	}
+}
+
+std::vector<std::vector<double>> DM_Detector_Nucleus::Nuclear_Recoil_Spectra(const std::vector<double>& ERs, const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	std::vector<std::vector<double>> spectra(target_nuclei.size(), std::vector<double>(ERs.size(), 0.0));
+	double vMax			    = DM_distr.Maximum_DM_Speed();
+	bool using_eta_function = DM.DD_use_eta_function && DM_distr.DD_use_eta_function;
+	// Recoil energies below the kinematic endpoint of the current isotope and their vMin
+	std::vector<unsigned int> kinematic_ERs;
+	std::vector<double> vMins;
+	kinematic_ERs.reserve(ERs.size());
+	vMins.reserve(ERs.size());
+	for(unsigned int i = 0; i < isotope_table.masses.size(); i++)
+	{
+		const Isotope& isotope		  = target_nuclei[isotope_table.nuclei[i]][isotope_table.isotopes[i]];
+		std::vector<double>& spectrum = spectra[isotope_table.nuclei[i]];
+		double mN					  = isotope_table.masses[i];
+		double vMin_factor			  = sqrt(mN / 2.0) / libphysica::Reduced_Mass(DM.mass, mN);
+		kinematic_ERs.clear();
+		vMins.clear();
+		for(unsigned int e = 0; e < ERs.size(); e++)
+		{
+			double vMin = vMin_factor * sqrt(ERs[e]);
+			if(vMin <= vMax)
+			{
+				kinematic_ERs.push_back(e);
+				vMins.push_back(vMin);
+			}
+		}
+		if(kinematic_ERs.empty())
+			continue;
+		else if(using_eta_function)
+		{
+			double rhoDM			 = DM_distr.DM_density * DM.fractional_density;
+			double vDM				 = 1.0e-3;	//cancels when eta function can be used
+			double prefactor		 = isotope_table.weights[i] / mN * rhoDM / DM.mass * vDM * vDM;
+			std::vector<double> etas = DM_distr.Eta_Function_Tabulated(vMins);
+			for(unsigned int k = 0; k < kinematic_ERs.size(); k++)
+			{
+				unsigned int e = kinematic_ERs[k];
+				spectrum[e] += prefactor * DM.dSigma_dER_Nucleus(ERs[e], isotope, vDM) * etas[k];
+			}
+		}
+		else
+		{
+			for(auto& e : kinematic_ERs)
+				spectrum[e] += isotope_table.weights[i] * dRdER_Nucleus(ERs[e], DM, DM_distr, isotope);
+		}
+	}
+	return spectra;
 }
 
 double DM_Detector_Nucleus::Maximum_Energy_Deposit(const DM_Particle& DM, const DM_Distribution& DM_distr) const
@@ -104,6 +173,18 @@ double DM_Detector_Nucleus::Minimum_DM_Mass(DM_Particle& DM, const DM_Distributi
 	return *std::min_element(aux.begin(), aux.end());
 }
 
+double DM_Detector_Nucleus::Efficiency(double E, unsigned int nucleus) const
+{
+	if(using_efficiency_tables)
+	{
+		if(efficiencies.size() == 1)
+			return efficiencies[0](E);
+		else if(efficiencies.size() == target_nuclei.size())
+			return efficiencies[nucleus](E);
+	}
+	return 1.0;
+}
+
 void DM_Detector_Nucleus::Set_Resolution(double res)
 {
 	energy_resolution = res;
@@ -112,7 +193,7 @@ void DM_Detector_Nucleus::Set_Resolution(double res)
 void DM_Detector_Nucleus::Import_Efficiency(std::string filename, double dim)
 {
 	using_efficiency_tables							  = true;
-	std::vector<std::vector<double>> efficiency_table = libphysica::Import_Table(filename);
+	std::vector<std::vector<double>> efficiency_table = Import_Data_Table(filename);
 	libphysica::Interpolation eff(efficiency_table, dim);
 	efficiencies.push_back(eff);
 }
@@ -124,25 +205,23 @@ void DM_Detector_Nucleus::Import_Efficiency(std::vector<std::string> filenames,
 		Import_Efficiency(filenames[i], dim);
 }
 
-double DM_Detector_Nucleus::dRdE(double E, const DM_Particle& DM, DM_Distribution& DM_distr)
+double DM_Detector_Nucleus::Detected_Recoil_Spectrum(double ER, double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const
 {
-
 	double dR = 0.0;
-	if(energy_resolution < 1e-6 * eV)
+	for(unsigned int i = 0; i < isotope_table.masses.size(); i++)
 	{
-		double eff = 1.0;
-		for(unsigned int i = 0; i < target_nuclei.size(); i++)
-		{
-			if(using_efficiency_tables)
-			{
-				if(efficiencies.size() == 1)
-					eff = efficiencies[0](E);
-				else if(efficiencies.size() == target_nuclei.size())
-					eff = efficiencies[i](E);
-			}
-			dR += eff * flat_efficiency * relative_mass_fractions[i] * dRdER_Nucleus(E, DM, DM_distr, target_nuclei[i]);
-		}
+		unsigned int nucleus = isotope_table.nuclei[i];
+		dR += Efficiency(E, nucleus) * isotope_table.weights[i] * dRdER_Nucleus(ER, DM, DM_distr, target_nuclei[nucleus][isotope_table.isotopes[i]]);
 	}
+	return flat_efficiency * dR;
+}
+
+double DM_Detector_Nucleus::dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+
+	double dR = 0.0;
+	if(energy_resolution < 1e-6 * eV)
+		dR = dRdE(std::vector<double>({E}), DM, DM_distr)[0];
 	else
 	{
 		//Find minimum and maximum ER contributing to dR/dE(E):
@@ -152,26 +231,98 @@ double DM_Detector_Nucleus::dRdE(double E, const DM_Particle& DM, DM_Distributio
 
 		//Convolute theoretical spectrum with Gaussian
 		std::function<double(double)> integrand = [this, E, &DM, &DM_distr](double ER) {
-			double dRtheory = 0.0;
-			for(unsigned int i = 0; i < target_nuclei.size(); i++)
-			{
-				double eff = 1.0;
-				if(using_efficiency_tables)
-				{
-					if(efficiencies.size() == 1)
-						eff = efficiencies[0](E);
-					else if(efficiencies.size() == target_nuclei.size())
-						eff = efficiencies[i](E);
-				}
-				dRtheory += eff * flat_efficiency * relative_mass_fractions[i] * dRdER_Nucleus(ER, DM, DM_distr, target_nuclei[i]);
-			}
-			return libphysica::PDF_Gauss(E, ER, energy_resolution) * dRtheory;
+			return libphysica::PDF_Gauss(E, ER, energy_resolution) * Detected_Recoil_Spectrum(ER, E, DM, DM_distr);
 		};
 		dR = libphysica::Integrate(integrand, eMin, eMax);
 	}
 	return dR;
 }
 
+DM_Detector_Nucleus::Resolution_Kernel DM_Detector_Nucleus::Compute_Resolution_Kernel(const std::vector<double>& energies) const
+{
+	Resolution_Kernel kernel;
+	kernel.ER_min = std::max(energy_threshold - 3.0 * energy_resolution, 2.0 * energy_resolution);
+	kernel.dER	  = energy_resolution / 2.0;
+
+	// Window of grid nodes [j_min, j_max] for each energy
+	std::vector<unsigned int> j_min, j_max;
+	for(auto& E : energies)
+	{
+		double eMin = std::max(E - 6.0 * energy_resolution, kernel.ER_min);
+		double eMax = E + 6.0 * energy_resolution;
+		if(eMax <= eMin)
+		{
+			j_min.push_back(1);
+			j_max.push_back(0);
+		}
+		else
+		{
+			j_min.push_back(std::floor((eMin - kernel.ER_min) / kernel.dER));
+			j_max.push_back(std::ceil((eMax - kernel.ER_min) / kernel.dER));
+			for(unsigned int j = j_min.back(); j <= j_max.back(); j++)
+				kernel.nodes.push_back(j);
+		}
+	}
+	std::sort(kernel.nodes.begin(), kernel.nodes.end());
+	kernel.nodes.erase(std::unique(kernel.nodes.begin(), kernel.nodes.end()), kernel.nodes.end());
+
+	// The spectrum is interpolated linearly between the nodes, and each segment is integrated exactly against the Gaussian.
+	for(unsigned int i = 0; i < energies.size(); i++)
+	{
+		double E = energies[i];
+		std::vector<double> weights;
+		if(j_max[i] > j_min[i])
+		{
+			weights.assign(j_max[i] - j_min[i] + 1, 0.0);
+			for(unsigned int j = j_min[i]; j < j_max[i]; j++)
+			{
+				double a  = kernel.ER_min + j * kernel.dER;
+				double b  = a + kernel.dER;
+				double I0 = 0.5 * (erf((b - E) / sqrt(2.0) / energy_resolution) - erf((a - E) / sqrt(2.0) / energy_resolution));
+				double I1 = energy_resolution * energy_resolution * (libphysica::PDF_Gauss(a, E, energy_resolution) - libphysica::PDF_Gauss(b, E, energy_resolution));
+				weights[j - j_min[i]] += ((b - E) * I0 - I1) / kernel.dER;
+				weights[j + 1 - j_min[i]] += ((E - a) * I0 + I1) / kernel.dER;
+			}
+		}
+		unsigned int first = (weights.empty()) ? 0 : std::lower_bound(kernel.nodes.begin(), kernel.nodes.end(), j_min[i]) - kernel.nodes.begin();
+		kernel.first_node.push_back(first);
+		kernel.weights.push_back(weights);
+	}
+	return kernel;
+}
+
+std::vector<double> DM_Detector_Nucleus::dRdE(const std::vector<double>& energies, const DM_Particle& DM, const DM_Distribution& DM_distr) const
+{
+	std::vector<double> dR(energies.size(), 0.0);
+	if(energy_resolution < 1e-6 * eV)
+	{
+		std::vector<std::vector<double>> spectra = Nuclear_Recoil_Spectra(energies, DM, DM_distr);
+		for(unsigned int e = 0; e < energies.size(); e++)
+			for(unsigned int i = 0; i < target_nuclei.size(); i++)
+				dR[e] += Efficiency(energies[e], i) * flat_efficiency * spectra[i][e];
+		return dR;
+	}
+
+	Resolution_Kernel kernel = Compute_Resolution_Kernel(energies);
+
+	// Theoretical spectra of all nuclei on the grid nodes
+	std::vector<double> ERs;
+	for(auto& node : kernel.nodes)
+		ERs.push_back(kernel.ER_min + node * kernel.dER);
+	std::vector<std::vector<double>> spectra = Nuclear_Recoil_Spectra(ERs, DM, DM_distr);
+
+	for(unsigned int e = 0; e < energies.size(); e++)
+	{
+		const std::vector<double>& weights = kernel.weights[e];
+		for(unsigned int i = 0; i < target_nuclei.size(); i++)
+		{
+			double dRsmeared = std::inner_product(weights.begin(), weights.end(), spectra[i].begin() + kernel.first_node[e], 0.0);
+			dR[e] += Efficiency(energies[e], i) * flat_efficiency * dRsmeared;
+		}
+	}
+	return dR;
+}
+
 double DM_Detector_Nucleus::Minimum_DM_Speed(const DM_Particle& DM) const
 {
 	double Emin = energy_threshold - 2.0 * energy_resolution;
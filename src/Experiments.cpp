@@ -3,6 +3,8 @@
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Utilities.hpp"
 
+#include "obscura/Data_Pack.hpp"
+
 namespace obscura
 {
 using namespace libphysica::natural_units;
@@ -54,7 +56,7 @@ DM_Detector_Nucleus CRESST_II()
 	std::vector<std::string> efficiency_files	= {PROJECT_DIR "data/CRESST-II/Lise_eff_AR_O.dat", PROJECT_DIR "data/CRESST-II/Lise_eff_AR_Ca.dat", PROJECT_DIR "data/CRESST-II/Lise_eff_AR_W.dat"};
 
 	DM_Detector_Nucleus detector("CRESST-II", CRESST_II_exposure, CRESST_II_targets, CRESST_II_target_ratios);
-	std::vector<double> energy_events = libphysica::Import_List(PROJECT_DIR "data/CRESST-II/Lise_AR.dat", keV);
+	std::vector<double> energy_events = Import_Data_List(PROJECT_DIR "data/CRESST-II/Lise_AR.dat", keV);
 	energy_events.push_back(CRESST_II_threshold);
 	energy_events.push_back(CRESST_II_Emax);
 	detector.Use_Maximum_Gap(energy_events);
@@ -78,7 +80,7 @@ DM_Detector_Nucleus CRESST_III()
 
 	DM_Detector_Nucleus detector("CRESST-III", CRESST_III_exposure, CRESST_III_targets, CRESST_III_target_ratios);
 	detector.Set_Flat_Efficiency(CRESST_III_efficiency);
-	std::vector<double> energy_events = libphysica::Import_List(PROJECT_DIR "data/CRESST-III/C3P1_DetA_AR.dat", keV);
+	std::vector<double> energy_events = Import_Data_List(PROJECT_DIR "data/CRESST-III/C3P1_DetA_AR.dat", keV);
 	energy_events.push_back(CRESST_III_threshold);
 	energy_events.push_back(CRESST_III_Emax);
 	detector.Use_Maximum_Gap(energy_events);
@@ -99,7 +101,7 @@ DM_Detector_Nucleus CRESST_surface()
 	double CRESST_surface_resolution				 = 3.74 * eV;
 
 	DM_Detector_Nucleus detector("CRESST-surface", CRESST_surface_exposure, CRESST_surface_targets, CRESST_surface_target_ratios);
-	std::vector<double> energy_events = libphysica::Import_List(PROJECT_DIR "data/CRESST-surface/data.txt", keV);
+	std::vector<double> energy_events = Import_Data_List(PROJECT_DIR "data/CRESST-surface/data.txt", keV);
 	energy_events.push_back(CRESST_surface_threshold);
 	energy_events.push_back(CRESST_surface_Emax);
 	detector.Use_Maximum_Gap(energy_events);
@@ -0,0 +1,224 @@
+#include "obscura/Optimum_Interval.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "obscura/Direct_Detection.hpp"
+
+namespace obscura
+{
+
+//1. Optimum interval method
+std::vector<double> Optimum_Interval_Maxima(const std::vector<double>& gaps, unsigned int n_max)
+{
+	std::vector<double> cumulative_gaps(gaps.size() + 1, 0.0);
+	std::partial_sum(gaps.begin(), gaps.end(), cumulative_gaps.begin() + 1);
+	std::vector<double> maxima(n_max + 1, cumulative_gaps.back());
+	// An interval with n events spans n+1 consecutive gaps. If there are no more than n events, the whole range counts.
+	for(unsigned int n = 0; n <= n_max && n + 1 < gaps.size(); n++)
+	{
+		double x_n = 0.0;
+		for(unsigned int i = 0; i + n + 1 <= gaps.size(); i++)
+			x_n = std::max(x_n, cumulative_gaps[i + n + 1] - cumulative_gaps[i]);
+		maxima[n] = x_n;
+	}
+	return maxima;
+}
+
+namespace
+{
+// Fraction of the samples below x, given their quantiles at equidistant probabilities.
+double Quantile_CDF(const double* quantiles, unsigned int number_of_quantiles, double x)
+{
+	if(x <= quantiles[0])
+		return 0.0;
+	else if(x > quantiles[number_of_quantiles - 1])
+		return 1.0;
+	unsigned int k = std::lower_bound(quantiles, quantiles + number_of_quantiles, x) - quantiles - 1;
+	double t	   = (x - quantiles[k]) / (quantiles[k + 1] - quantiles[k]);
+	return (k + t) / (number_of_quantiles - 1.0);
+}
+
+// Quantiles at equidistant probabilities, interpolated between the order statistics.
+void Sample_Quantiles(std::vector<double>& samples, unsigned int number_of_quantiles, double* quantiles)
+{
+	std::sort(samples.begin(), samples.end());
+	for(unsigned int k = 0; k < number_of_quantiles; k++)
+	{
+		double position = k * (samples.size() - 1.0) / (number_of_quantiles - 1.0);
+		unsigned int i	= std::min<unsigned int>(position, samples.size() - 2);
+		quantiles[k]	= samples[i] + (position - i) * (samples[i + 1] - samples[i]);
+	}
+}
+}	// namespace
+
+const char table_magic[8]						    = {'O', 'B', 'S', 'C', 'O', 'P', 'T', 'I'};
+const std::uint32_t Optimum_Interval_Table::version = 1;
+
+// Header: magic, version, byte order, number of mus, n_max, number of quantiles, padding
+const std::size_t table_header_size = 8 + 6 * 4;
+
+Optimum_Interval_Table::Optimum_Interval_Table(const std::string& filepath)
+: path(filepath), number_of_mus(0), n_max(0), number_of_quantiles(0), mu_grid(nullptr), x_quantiles(nullptr), C_max_quantiles(nullptr)
+{
+	if(!file.Map(path, table_header_size))
+		return;
+
+	std::uint32_t header[6];
+	std::memcpy(header, file.Data() + 8, sizeof(header));
+	number_of_mus		= header[2];
+	n_max				= header[3];
+	number_of_quantiles = header[4];
+
+	std::size_t expected_size = table_header_size + 8 * ((std::size_t) number_of_mus * (1 + (n_max + 2) * (std::size_t) number_of_quantiles));
+	std::string problem		  = file.Check_Header(table_magic, version, "an optimum interval table");
+	if(problem.empty() && (number_of_mus < 2 || number_of_quantiles < 2 || file.Size() != expected_size))
+		problem = "corrupted file";
+	if(!problem.empty())
+	{
+		std::cerr << "Warning in obscura::Optimum_Interval_Table::Optimum_Interval_Table(): Ignoring " << path << " (" << problem << ")." << std::endl;
+		file.Unmap();
+		return;
+	}
+	mu_grid			= reinterpret_cast<const double*>(file.Data() + table_header_size);
+	x_quantiles		= mu_grid + number_of_mus;
+	C_max_quantiles = x_quantiles + (std::size_t) number_of_mus * (n_max + 1) * number_of_quantiles;
+}
+
+bool Optimum_Interval_Table::Is_Open() const
+{
+	return file.Is_Mapped();
+}
+
+double Optimum_Interval_Table::Minimum_Mu() const
+{
+	return mu_grid[0];
+}
+
+double Optimum_Interval_Table::Maximum_Mu() const
+{
+	return mu_grid[number_of_mus - 1];
+}
+
+unsigned int Optimum_Interval_Table::Maximum_Interval_Events() const
+{
+	return n_max;
+}
+
+bool Optimum_Interval_Table::Covers(double mu) const
+{
+	return mu > Minimum_Mu() && mu < Maximum_Mu();
+}
+
+double Optimum_Interval_Table::P_Value(unsigned int mu_index, const std::vector<double>& x_fractions) const
+{
+	double C_max = 0.0;
+	for(unsigned int n = 0; n <= n_max; n++)
+	{
+		const double* quantiles = x_quantiles + ((std::size_t) mu_index * (n_max + 1) + n) * number_of_quantiles;
+		C_max					= std::max(C_max, Quantile_CDF(quantiles, number_of_quantiles, x_fractions[n]));
+	}
+	return 1.0 - Quantile_CDF(C_max_quantiles + (std::size_t) mu_index * number_of_quantiles, number_of_quantiles, C_max);
+}
+
+double Optimum_Interval_Table::P_Value(const std::vector<double>& gaps) const
+{
+	double mu = std::accumulate(gaps.begin(), gaps.end(), 0.0);
+	if(!Covers(mu))
+		return 1.0 - CDF_Maximum_Gap(*std::max_element(gaps.begin(), gaps.end()), mu);
+
+	std::vector<double> x_fractions = Optimum_Interval_Maxima(gaps, n_max);
+	for(auto& x : x_fractions)
+		x /= mu;
+	unsigned int j = std::upper_bound(mu_grid, mu_grid + number_of_mus, mu) - mu_grid - 1;
+	double t	   = log(mu / mu_grid[j]) / log(mu_grid[j + 1] / mu_grid[j]);
+	return (1.0 - t) * P_Value(j, x_fractions) + t * P_Value(j + 1, x_fractions);
+}
+
+bool Create_Optimum_Interval_Table(const std::vector<double>& mu_grid, unsigned int n_max, unsigned int samples, unsigned int quantiles, unsigned int threads, unsigned long int seed, const std::string& table_path)
+{
+	if(mu_grid.size() < 2 || !std::is_sorted(mu_grid.begin(), mu_grid.end(), std::less_equal<double>()) || mu_grid.front() <= 0.0 || samples < 2 || quantiles < 2)
+	{
+		std::cerr << "Error in obscura::Create_Optimum_Interval_Table(): The mu grid has to consist of at least 2 strictly increasing, positive values, with at least 2 samples and quantiles." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	if(threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	unsigned int N_mu = mu_grid.size();
+	std::vector<double> x_table((std::size_t) N_mu * (n_max + 1) * quantiles);
+	std::vector<double> C_max_table((std::size_t) N_mu * quantiles);
+
+	// The samples are simulated in blocks with their own seeds, so that the result does not depend on the threads.
+	const unsigned int block_size = 1000;
+	unsigned int blocks			  = (samples + block_size - 1) / block_size;
+	for(unsigned int j = 0; j < N_mu; j++)
+	{
+		double mu = mu_grid[j];
+		// x_fractions[n][sample]
+		std::vector<std::vector<double>> x_fractions(n_max + 1, std::vector<double>(samples));
+		auto simulate_blocks = [mu, n_max, samples, blocks, threads, seed, j, &x_fractions](unsigned int thread) {
+			for(unsigned int b = thread; b < blocks; b += threads)
+			{
+				std::seed_seq seed_sequence {(unsigned long int) seed, (unsigned long int) j, (unsigned long int) b};
+				std::mt19937_64 generator(seed_sequence);
+				std::poisson_distribution<unsigned int> poisson(mu);
+				std::uniform_real_distribution<double> uniform(0.0, mu);
+				for(unsigned int s = b * block_size; s < std::min(samples, (b + 1) * block_size); s++)
+				{
+					std::vector<double> events(poisson(generator));
+					for(auto& event : events)
+						event = uniform(generator);
+					std::sort(events.begin(), events.end());
+					std::vector<double> gaps;
+					double previous = 0.0;
+					for(auto& event : events)
+					{
+						gaps.push_back(event - previous);
+						previous = event;
+					}
+					gaps.push_back(mu - previous);
+					std::vector<double> maxima = Optimum_Interval_Maxima(gaps, n_max);
+					for(unsigned int n = 0; n <= n_max; n++)
+						x_fractions[n][s] = maxima[n] / mu;
+				}
+			}
+		};
+		std::vector<std::thread> thread_pool;
+		for(unsigned int t = 0; t < threads; t++)
+			thread_pool.emplace_back(simulate_blocks, t);
+		for(auto& thread : thread_pool)
+			thread.join();
+
+		// Quantiles of x_n / mu, and of C_max evaluated with the same quantiles as at runtime.
+		double* x_quantiles = &x_table[(std::size_t) j * (n_max + 1) * quantiles];
+		for(unsigned int n = 0; n <= n_max; n++)
+		{
+			std::vector<double> sorted_fractions = x_fractions[n];
+			Sample_Quantiles(sorted_fractions, quantiles, x_quantiles + (std::size_t) n * quantiles);
+		}
+		std::vector<double> C_maxs(samples, 0.0);
+		for(unsigned int s = 0; s < samples; s++)
+			for(unsigned int n = 0; n <= n_max; n++)
+				C_maxs[s] = std::max(C_maxs[s], Quantile_CDF(x_quantiles + (std::size_t) n * quantiles, quantiles, x_fractions[n][s]));
+		Sample_Quantiles(C_maxs, quantiles, &C_max_table[(std::size_t) j * quantiles]);
+	}
+
+	std::ofstream file(table_path, std::ios::binary);
+	if(!file)
+		return false;
+	std::uint32_t header[6] = {Optimum_Interval_Table::version, Mapped_File::byte_order_marker, N_mu, n_max, quantiles, 0};
+	file.write(table_magic, 8);
+	file.write(reinterpret_cast<const char*>(header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(mu_grid.data()), 8 * mu_grid.size());
+	file.write(reinterpret_cast<const char*>(x_table.data()), 8 * x_table.size());
+	file.write(reinterpret_cast<const char*>(C_max_table.data()), 8 * C_max_table.size());
+	return file.good();
+}
+
+}	// namespace obscura
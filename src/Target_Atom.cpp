@@ -2,10 +2,16 @@
 
 #include <cmath>
 #include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Utilities.hpp"
 
+#include "obscura/Data_Pack.hpp"
+
 namespace obscura
 {
 using namespace libphysica::natural_units;
@@ -16,41 +22,149 @@ double vMinimal_Electrons(double q, double Delta_E, double mDM)
 	return (Delta_E / q + q / 2.0 / mDM);
 }
 
+//2. Bilinear interpolation on logarithmically spaced grids
+Log_Grid_Interpolation_2D::Log_Grid_Interpolation_2D()
+: log_x_min(0.0), log_y_min(0.0), inverse_dlog_x(0.0), inverse_dlog_y(0.0)
+{
+}
+
+Log_Grid_Interpolation_2D::Log_Grid_Interpolation_2D(double x_min, double x_max, double y_min, double y_max, const std::vector<std::vector<double>>& table)
+{
+	unsigned int Nx = table.size();
+	unsigned int Ny = table.empty() ? 0 : table[0].size();
+	if(Nx < 2 || Ny < 2)
+	{
+		std::cerr << "Error in obscura::Log_Grid_Interpolation_2D::Log_Grid_Interpolation_2D(): Table of size " << Nx << "x" << Ny << " is too small." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	x_grid		   = libphysica::Log_Space(x_min, x_max, Nx);
+	y_grid		   = libphysica::Log_Space(y_min, y_max, Ny);
+	log_x_min	   = std::log(x_min);
+	log_y_min	   = std::log(y_min);
+	inverse_dlog_x = (Nx - 1.0) / std::log(x_max / x_min);
+	inverse_dlog_y = (Ny - 1.0) / std::log(y_max / y_min);
+	values.reserve(Nx * Ny);
+	for(auto& row : table)
+	{
+		if(row.size() != Ny)
+		{
+			std::cerr << "Error in obscura::Log_Grid_Interpolation_2D::Log_Grid_Interpolation_2D(): Table is not rectangular." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		values.insert(values.end(), row.begin(), row.end());
+	}
+}
+
+// Index i of the cell [grid[i],grid[i+1]] containing the value. Outside the grid, the boundary cells are used (linear extrapolation).
+unsigned int Log_Grid_Interpolation_2D::Index(double log_value, double log_min, double inverse_dlog, const std::vector<double>& grid, double value) const
+{
+	double position = (log_value - log_min) * inverse_dlog;
+	if(!(position > 0.0))
+		return 0;
+	unsigned int i_max = grid.size() - 2;
+	if(position >= i_max)
+		return i_max;
+	unsigned int i = position;
+	// Correct for rounding errors of the logarithm close to grid points.
+	if(value < grid[i] && i > 0)
+		i--;
+	else if(value >= grid[i + 1] && i < i_max)
+		i++;
+	return i;
+}
+
+double Log_Grid_Interpolation_2D::operator()(double x, double y) const
+{
+	unsigned int i = Index(std::log(x), log_x_min, inverse_dlog_x, x_grid, x);
+	unsigned int j = Index(std::log(y), log_y_min, inverse_dlog_y, y_grid, y);
+	double t	   = (x - x_grid[i]) / (x_grid[i + 1] - x_grid[i]);
+	double u	   = (y - y_grid[j]) / (y_grid[j + 1] - y_grid[j]);
+
+	const double* f_i  = &values[i * y_grid.size() + j];
+	const double* f_i1 = f_i + y_grid.size();
+	return (1.0 - t) * ((1.0 - u) * f_i[0] + u * f_i[1]) + t * ((1.0 - u) * f_i1[0] + u * f_i1[1]);
+}
+
+std::vector<double> Log_Grid_Interpolation_2D::operator()(const std::vector<double>& xs, const std::vector<double>& ys) const
+{
+	if(xs.size() != ys.size())
+	{
+		std::cerr << "Error in obscura::Log_Grid_Interpolation_2D::operator()(): Number of x values (" << xs.size() << ") and y values (" << ys.size() << ") does not match." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	std::vector<double> results(xs.size());
+	for(unsigned int i = 0; i < xs.size(); i++)
+		results[i] = (*this)(xs[i], ys[i]);
+	return results;
+}
+
 //3. Bound electrons in isolated atoms
 std::string s_names[5] = {"s", "p", "d", "f", "g"};
 
+Ionization_Form_Factor_Table::Ionization_Form_Factor_Table(const std::string& shell_name, double k_min, double k_max, double q_min, double q_max)
+{
+	//Import the table.
+	std::string path									= PROJECT_DIR "data/Form_Factors_Ionization/" + shell_name + ".txt";
+	std::vector<std::vector<double>> form_factor_tables = Import_Data_Table(path);
+
+	interpolation = Log_Grid_Interpolation_2D(k_min, k_max, q_min, q_max, form_factor_tables);
+}
+
+std::shared_ptr<const Ionization_Form_Factor_Table> Get_Ionization_Form_Factor_Table(const std::string& shell_name, double k_min, double k_max, double q_min, double q_max)
+{
+	static std::map<std::tuple<std::string, double, double, double, double>, std::shared_ptr<const Ionization_Form_Factor_Table>> tables;
+	static std::mutex tables_mutex;
+
+	std::lock_guard<std::mutex> lock(tables_mutex);
+	auto key = std::make_tuple(shell_name, k_min, k_max, q_min, q_max);
+	auto it	 = tables.find(key);
+	if(it == tables.end())
+		it = tables.emplace(key, std::make_shared<const Ionization_Form_Factor_Table>(shell_name, k_min, k_max, q_min, q_max)).first;
+	return it->second;
+}
+
 Atomic_Electron::Atomic_Electron(std::string element, int N, int L, double Ebinding, double kMin, double kMax, double qMin, double qMax, unsigned int neSecondary)
 : k_min(kMin), k_max(kMax), q_min(qMin), q_max(qMax), n(N), l(L), binding_energy(Ebinding), number_of_secondary_electrons(neSecondary)
 {
-	name = element + "_" + std::to_string(n) + s_names[l];
-	//Import the table.
-	std::string path									= PROJECT_DIR "data/Form_Factors_Ionization/" + name + ".txt";
-	std::vector<std::vector<double>> form_factor_tables = libphysica::Import_Table(path);
+	name			  = element + "_" + std::to_string(n) + s_names[l];
+	form_factor_table = Get_Ionization_Form_Factor_Table(name, k_min, k_max, q_min, q_max);
 
-	Nk						  = form_factor_tables.size();
-	Nq						  = form_factor_tables[0].size();
-	k_Grid					  = libphysica::Log_Space(k_min, k_max, Nk);
-	q_Grid					  = libphysica::Log_Space(q_min, q_max, Nq);
-	form_factor_interpolation = libphysica::Interpolation_2D(k_Grid, q_Grid, form_factor_tables);
-	dlogk					  = log10(k_max / k_min) / (Nk - 1.0);
-	dlogq					  = log10(q_max / q_min) / (Nq - 1.0);
+	Nk	  = k_Grid().size();
+	Nq	  = q_Grid().size();
+	dlogk = log10(k_max / k_min) / (Nk - 1.0);
+	dlogq = log10(q_max / q_min) / (Nq - 1.0);
 }
 
-double Atomic_Electron::Ionization_Form_Factor(double q, double E)
+double Atomic_Electron::Ionization_Form_Factor(double q, double E) const
 {
 	double k = sqrt(2.0 * mElectron * E);
 	if(q > q_min)
-		return form_factor_interpolation(k, q);
+		return form_factor_table->interpolation(k, q);
 	else
 	{
 		// Dipole approximation for low q
 		// See eq. 6 of arXiv:1908.10881
 		double q_0	= q_min;
-		double FF_0 = form_factor_interpolation(k, q_0);
+		double FF_0 = form_factor_table->interpolation(k, q_0);
 		return q * q / q_0 / q_0 * FF_0;
 	}
 }
 
+std::vector<double> Atomic_Electron::Ionization_Form_Factor(const std::vector<double>& qs, const std::vector<double>& Es) const
+{
+	std::vector<double> ks(Es.size()), qs_table(qs);
+	for(unsigned int i = 0; i < Es.size(); i++)
+		ks[i] = sqrt(2.0 * mElectron * Es[i]);
+	for(auto& q : qs_table)
+		if(q <= q_min)
+			q = q_min;
+	std::vector<double> form_factors = form_factor_table->interpolation(ks, qs_table);
+	for(unsigned int i = 0; i < qs.size(); i++)
+		if(qs[i] <= q_min)
+			form_factors[i] *= qs[i] * qs[i] / q_min / q_min;
+	return form_factors;
+}
+
 void Atomic_Electron::Print_Summary(unsigned int MPI_rank) const
 {
 	if(MPI_rank == 0)
@@ -119,7 +233,7 @@ double Atom::Lowest_Binding_Energy() const
 	return binding_energy_min;
 }
 
-Atomic_Electron Atom::Electron(unsigned int n, unsigned int l)
+const Atomic_Electron& Atom::Electron(unsigned int n, unsigned int l) const
 {
 	for(unsigned int i = 0; i < electrons.size(); i++)
 	{
@@ -1,10 +1,13 @@
 #include "obscura/Target_Crystal.hpp"
 
 #include <cmath>
+#include <iostream>
 
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Utilities.hpp"
 
+#include "obscura/Data_Pack.hpp"
+
 #include "version.hpp"
 
 namespace obscura
@@ -12,7 +15,7 @@ namespace obscura
 using namespace libphysica::natural_units;
 
 Crystal::Crystal(std::string target)
-: name(target), dE(0.1 * eV), dq(0.02 * aEM * mElectron)
+: name(target), dE(0.1 * eV), dq(0.02 * aEM * mElectron), N_E(500), N_q(900)
 {
 	double prefactor;
 	if(name == "Si")
@@ -38,21 +41,54 @@ Crystal::Crystal(std::string target)
 	}
 	//Import the form factor
 	std::string path			 = PROJECT_DIR "data/Semiconductors/C." + target + "137.dat";
-	std::vector<double> aux_list = libphysica::Import_List(path);
-	std::vector<std::vector<double>> form_factor_table(900, std::vector<double>(500, 0.0));
-	double wk	   = 2.0 / 137.0;
-	unsigned int i = 0;
-	for(int Ei = 0; Ei < 500; Ei++)
-		for(int qi = 0; qi < 900; qi++)
-			form_factor_table[qi][Ei] = prefactor * (qi + 1) / dE * wk / 4.0 * aux_list[i++];
-	std::vector<double> q_grid = libphysica::Linear_Space(dq, 900 * dq, 900);
-	std::vector<double> E_grid = libphysica::Linear_Space(dE, 500 * dE, 500);
-	form_factor_interpolation  = libphysica::Interpolation_2D(q_grid, E_grid, form_factor_table);
+	std::vector<double> aux_list = Import_Data_List(path);
+	if(aux_list.size() != N_E * N_q)
+	{
+		std::cerr << "Error in obscura::Crystal::Crystal(): Form factor table of " << target << " has " << aux_list.size() << " instead of " << N_E * N_q << " entries." << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	form_factor_table = std::vector<double>(N_E * N_q, 0.0);
+	double wk		  = 2.0 / 137.0;
+	unsigned int i	  = 0;
+	for(unsigned int Ei = 0; Ei < N_E; Ei++)
+		for(unsigned int qi = 0; qi < N_q; qi++)
+		{
+			form_factor_table[i] = prefactor * (qi + 1) / dE * wk / 4.0 * aux_list[i];
+			i++;
+		}
 }
 
-double Crystal::Crystal_Form_Factor(double q, double E)
+// Position x of the argument on the grid (i.e. value = (x+1)*step) and the index of the lower cell boundary.
+// Outside the grid, the boundary cells are used (linear extrapolation).
+unsigned int Grid_Cell(double value, double step, unsigned int N, double& x)
 {
-	return form_factor_interpolation(q, E);
+	x = value / step - 1.0;
+	if(!(x > 0.0))
+		return 0;
+	else if(x >= N - 2.0)
+		return N - 2;
+	else
+		return x;
+}
+
+double Crystal::Crystal_Form_Factor(double q, double E) const
+{
+	double x_q, x_E;
+	unsigned int qi = Grid_Cell(q, dq, N_q, x_q);
+	unsigned int Ei = Grid_Cell(E, dE, N_E, x_E);
+	double t		= x_q - qi;
+	double u		= x_E - Ei;
+	// Points on the grid, e.g. in the crystal rate computation, do not require any interpolation.
+	if(std::fabs(t) < 1.0e-9)
+		t = 0.0;
+	if(std::fabs(u) < 1.0e-9)
+		u = 0.0;
+	if(t == 0.0 && u == 0.0)
+		return Crystal_Form_Factor(qi, Ei);
+
+	const double* f_E  = Crystal_Form_Factor_Row(Ei);
+	const double* f_E1 = f_E + N_q;
+	return (1.0 - u) * ((1.0 - t) * f_E[qi] + t * f_E[qi + 1]) + u * ((1.0 - t) * f_E1[qi] + t * f_E1[qi + 1]);
 }
 
 }	// namespace obscura
\ No newline at end of file
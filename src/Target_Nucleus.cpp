@@ -3,10 +3,13 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Special_Functions.hpp"
 
+#include "obscura/Data_Pack.hpp"
+
 namespace obscura
 {
 
@@ -15,11 +18,12 @@ using namespace libphysica::natural_units;
 //1. Kinematic functions
 double vMinimal_Nucleus(double ER, double mDM, double mNucleus)
 {
-	return sqrt(mNucleus * ER / 2.0 / pow(libphysica::Reduced_Mass(mDM, mNucleus), 2.0));
+	return sqrt(mNucleus * ER / 2.0) / libphysica::Reduced_Mass(mDM, mNucleus);
 }
 double Maximum_Nuclear_Recoil_Energy(double vDM, double mDM, double mNucleus)
 {
-	return 2.0 * vDM * vDM * pow(libphysica::Reduced_Mass(mDM, mNucleus), 2.0) / mNucleus;
+	double mu = libphysica::Reduced_Mass(mDM, mNucleus);
+	return 2.0 * vDM * vDM * mu * mu / mNucleus;
 }
 
 //2. Class for nuclear isotopes.
@@ -50,11 +54,11 @@ double Isotope::Helm_Form_Factor(double q) const
 	if(q < 1.0e-6 * MeV)
 		return 1.0;
 	double a  = 0.52 * fm;
-	double c  = (1.23 * pow(A, 1.0 / 3.0) - 0.6) * fm;
+	double c  = (1.23 * cbrt(A) - 0.6) * fm;
 	double s  = 0.9 * fm;
-	double rn = sqrt(c * c + 7.0 / 3.0 * pow(M_PI * a, 2.0) - 5.0 * s * s);
+	double rn = sqrt(c * c + 7.0 / 3.0 * M_PI * M_PI * a * a - 5.0 * s * s);
 	double qr = q * rn;
-	return 3.0 * (sin(qr) / pow(qr, 3.0) - cos(qr) / pow(qr, 2.0)) * exp(-q * q * s * s / 2.0);
+	return 3.0 * (sin(qr) - qr * cos(qr)) / (qr * qr * qr) * exp(-q * q * s * s / 2.0);
 }
 
 void Isotope::Print_Summary(unsigned int MPI_rank) const
@@ -130,24 +134,13 @@ Isotope Nucleus::Get_Isotope(unsigned int A) const
 //4. Nuclear data
 //Import the nuclear data from a file
 std::vector<Nucleus> all_nuclei;
+std::once_flag all_nuclei_imported;
 std::vector<Nucleus> Import_Nuclear_Data()
 {
 	std::vector<Nucleus> nuclei = {};
 	std::vector<Isotope> isotopes;
-	std::string path = PROJECT_DIR "data/Nuclear_Data.txt";
-	std::ifstream f;
-	f.open(path);
-	if(!f)
-	{
-		std::cerr << "Error in obscura::Import_Nuclear_Data(): Data file " << path << " not found." << std::endl;
-		std::exit(EXIT_FAILURE);
-	}
-	std::string name;
-	int Z, A;
-	double abund, spin, sp, sn;
 	int Zold = 1;
-	while(f >> name >> Z >> A >> abund >> spin >> sp >> sn)
-	{
+	auto add_isotope = [&nuclei, &isotopes, &Zold](int Z, int A, double abund, double spin, double sp, double sn) {
 		if(Z > Zold)
 		{
 			nuclei.push_back(Nucleus(isotopes));
@@ -155,9 +148,31 @@ std::vector<Nucleus> Import_Nuclear_Data()
 			Zold = Z;
 		}
 		isotopes.push_back(Isotope(Z, A, abund, spin, sp, sn));
+	};
+
+	// The binary data pack stores the table without the element names.
+	std::vector<std::vector<double>> table;
+	if(Default_Data_Pack().Import_Table("Nuclear_Data.txt", table))
+		for(auto& row : table)
+			add_isotope(row[0], row[1], row[2], row[3], row[4], row[5]);
+	else
+	{
+		std::string path = PROJECT_DIR "data/Nuclear_Data.txt";
+		std::ifstream f;
+		f.open(path);
+		if(!f)
+		{
+			std::cerr << "Error in obscura::Import_Nuclear_Data(): Data file " << path << " not found." << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		std::string name;
+		int Z, A;
+		double abund, spin, sp, sn;
+		while(f >> name >> Z >> A >> abund >> spin >> sp >> sn)
+			add_isotope(Z, A, abund, spin, sp, sn);
+		f.close();
 	}
 	nuclei.push_back(Nucleus(isotopes));
-	f.close();
 	return nuclei;
 }
 
@@ -173,8 +188,7 @@ Nucleus Get_Nucleus(unsigned int Z)
 		std::cerr << "Error in obscura::Get_Nucleus(): Input Z=" << Z << " is not a value between 1 and 92." << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
-	else if(all_nuclei.size() == 0)
-		all_nuclei = Import_Nuclear_Data();
+	std::call_once(all_nuclei_imported, []() { all_nuclei = Import_Nuclear_Data(); });
 
 	return all_nuclei[Z - 1];
 }
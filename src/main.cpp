@@ -3,6 +3,10 @@
 #include <cstring>	 // for strlen
 #include <iostream>
 
+#ifdef OBSCURA_USE_MPI
+	#include <mpi.h>
+#endif
+
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Special_Functions.hpp"
 #include "libphysica/Utilities.hpp"
@@ -15,42 +19,83 @@ using namespace obscura;
 
 int main(int argc, char* argv[])
 {
+	int MPI_processes = 1;
+	int MPI_rank	  = 0;
+#ifdef OBSCURA_USE_MPI
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD, &MPI_processes);
+	MPI_Comm_rank(MPI_COMM_WORLD, &MPI_rank);
+#endif
+
 	//Initial terminal output
 	auto time_start	  = std::chrono::system_clock::now();
 	auto time_start_t = std::chrono::system_clock::to_time_t(time_start);
 	auto* ctime_start = ctime(&time_start_t);
 	if(ctime_start[std::strlen(ctime_start) - 1] == '\n')
 		ctime_start[std::strlen(ctime_start) - 1] = '\0';
-	std::cout << "[Started on " << ctime_start << "]" << std::endl;
-	std::cout << PROJECT_NAME << "-v" << PROJECT_VERSION << "\tgit:" << GIT_BRANCH << "/" << GIT_COMMIT_HASH << std::endl
-			  << OBSCURA_LOGO
-			  << std::endl;
+	if(MPI_rank == 0)
+	{
+		std::cout << "[Started on " << ctime_start << "]" << std::endl;
+		std::cout << PROJECT_NAME << "-v" << PROJECT_VERSION << "\tgit:" << GIT_BRANCH << "/" << GIT_COMMIT_HASH << std::endl
+				  << OBSCURA_LOGO
+				  << std::endl;
+		if(MPI_processes > 1)
+			std::cout << "MPI processes:\t" << MPI_processes << std::endl;
+	}
 	////////////////////////////////////////////////////////////////////////
 
 	//Import configuration file
-	obscura::Configuration cfg(argv[1]);
-	cfg.Print_Summary();
+	obscura::Configuration cfg(argv[1], MPI_rank);
+	cfg.Print_Summary(MPI_rank);
 
 	std::vector<double> DM_masses = libphysica::Log_Space(cfg.constraints_mass_min, cfg.constraints_mass_max, cfg.constraints_masses);
 
-	std::vector<std::vector<double>> exclusion_limits = cfg.DM_detector->Upper_Limit_Curve(*(cfg.DM), *(cfg.DM_distr), DM_masses, cfg.constraints_certainty);
-	for(unsigned int i = 0; i < exclusion_limits.size(); i++)
-		std::cout << i + 1 << "/" << exclusion_limits.size()
-				  << "\tmDM = " << libphysica::Round(In_Units(exclusion_limits[i][0], (exclusion_limits[i][0] < GeV) ? MeV : GeV)) << ((exclusion_limits[i][0] < GeV) ? " MeV" : " GeV")
-				  << "\tUpper Bound:\t" << libphysica::Round(In_Units(exclusion_limits[i][1], cm * cm)) << std::endl;
+	// Every MPI process computes the limits for every MPI_processes-th mass.
+	std::vector<double> local_masses;
+	for(unsigned int i = MPI_rank; i < DM_masses.size(); i += MPI_processes)
+		local_masses.push_back(DM_masses[i]);
+	std::vector<std::vector<double>> local_limits = cfg.DM_detector->Upper_Limit_Curve(*(cfg.DM), *(cfg.DM_distr), local_masses, cfg.constraints_certainty, cfg.constraints_threads);
+
+	// Collect the limits of all processes (-1 marks masses without limit or computed by another process).
+	std::vector<double> upper_bounds(DM_masses.size(), -1.0);
+	for(auto& limit : local_limits)
+		for(unsigned int i = MPI_rank; i < DM_masses.size(); i += MPI_processes)
+			if(DM_masses[i] == limit[0])
+				upper_bounds[i] = limit[1];
+#ifdef OBSCURA_USE_MPI
+	MPI_Allreduce(MPI_IN_PLACE, upper_bounds.data(), upper_bounds.size(), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+	std::vector<std::vector<double>> exclusion_limits;
+	for(unsigned int i = 0; i < DM_masses.size(); i++)
+		if(upper_bounds[i] > 0.0)
+			exclusion_limits.push_back({DM_masses[i], upper_bounds[i]});
+
+	if(MPI_rank == 0)
+	{
+		for(unsigned int i = 0; i < exclusion_limits.size(); i++)
+			std::cout << i + 1 << "/" << exclusion_limits.size()
+					  << "\tmDM = " << libphysica::Round(In_Units(exclusion_limits[i][0], (exclusion_limits[i][0] < GeV) ? MeV : GeV)) << ((exclusion_limits[i][0] < GeV) ? " MeV" : " GeV")
+					  << "\tUpper Bound:\t" << libphysica::Round(In_Units(exclusion_limits[i][1], cm * cm)) << std::endl;
 
-	int CL = std::round(100.0 * cfg.constraints_certainty);
-	libphysica::Export_Table(TOP_LEVEL_DIR "results/" + cfg.ID + "/DD_Constraints_" + std::to_string(CL) + ".txt", exclusion_limits, {GeV, cm * cm});
+		int CL = std::round(100.0 * cfg.constraints_certainty);
+		libphysica::Export_Table(TOP_LEVEL_DIR "results/" + cfg.ID + "/DD_Constraints_" + std::to_string(CL) + ".txt", exclusion_limits, {GeV, cm * cm});
+	}
 
 	////////////////////////////////////////////////////////////////////////
 	//Final terminal output
 	auto time_end		 = std::chrono::system_clock::now();
 	double durationTotal = 1e-6 * std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count();
-	std::cout << "\n[Finished in " << std::round(1000. * durationTotal) / 1000. << "s";
-	if(durationTotal > 60.0)
-		std::cout << " (" << floor(durationTotal / 3600.0) << ":" << floor(fmod(durationTotal / 60.0, 60.0)) << ":" << floor(fmod(durationTotal, 60.0)) << ")]." << std::endl;
-	else
-		std::cout << "]" << std::endl;
+	if(MPI_rank == 0)
+	{
+		std::cout << "\n[Finished in " << std::round(1000. * durationTotal) / 1000. << "s";
+		if(durationTotal > 60.0)
+			std::cout << " (" << floor(durationTotal / 3600.0) << ":" << floor(fmod(durationTotal / 60.0, 60.0)) << ":" << floor(fmod(durationTotal, 60.0)) << ")]." << std::endl;
+		else
+			std::cout << "]" << std::endl;
+	}
 
+#ifdef OBSCURA_USE_MPI
+	MPI_Finalize();
+#endif
 	return 0;
 }
\ No newline at end of file
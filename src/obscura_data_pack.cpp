@@ -0,0 +1,19 @@
+#include <iostream>
+#include <string>
+
+#include "obscura/Data_Pack.hpp"
+#include "version.hpp"
+
+// Convert the numerical tables of the data folder into a binary data pack, which obscura then reads via mmap.
+// Usage: ./obscura_data_pack [data folder] [pack file]
+int main(int argc, char* argv[])
+{
+	std::string data_folder = (argc > 1) ? argv[1] : PROJECT_DIR "data/";
+	std::string pack_path	= (argc > 2) ? argv[2] : PROJECT_DIR "data/obscura_data.pack";
+
+	std::cout << "Packing the tables in " << data_folder << std::endl;
+	unsigned int tables = obscura::Create_Data_Pack(data_folder, pack_path);
+	std::cout << "Wrote " << tables << " tables to " << pack_path << " (format version " << obscura::Data_Pack::version << ")." << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,29 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/Optimum_Interval.hpp"
+#include "version.hpp"
+
+// Generate the Monte Carlo calibration table of the optimum interval method, which obscura then reads via mmap.
+// Usage: ./obscura_optimum_interval [samples per mu] [threads] [table file]
+int main(int argc, char* argv[])
+{
+	unsigned int samples   = (argc > 1) ? std::atoi(argv[1]) : 100000;
+	unsigned int threads   = (argc > 2) ? std::atoi(argv[2]) : 0;
+	std::string table_path = (argc > 3) ? argv[3] : PROJECT_DIR "data/optimum_interval.table";
+
+	std::vector<double> mu_grid = libphysica::Log_Space(0.1, 1000.0, 101);
+	unsigned int n_max			= 100;
+	std::cout << "Simulating " << samples << " experiments for each of " << mu_grid.size() << " values of mu in [" << mu_grid.front() << "," << mu_grid.back() << "]." << std::endl;
+	if(!obscura::Create_Optimum_Interval_Table(mu_grid, n_max, samples, 201, threads, 1, table_path))
+	{
+		std::cerr << "Error in obscura_optimum_interval: Could not write " << table_path << "." << std::endl;
+		return 1;
+	}
+	std::cout << "Wrote the optimum interval table to " << table_path << " (format version " << obscura::Optimum_Interval_Table::version << ")." << std::endl;
+
+	return 0;
+}
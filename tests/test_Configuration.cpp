@@ -25,6 +25,7 @@ TEST(TestConfiguration, TestReadConfig1)
 	EXPECT_EQ(cfg.ID, "test1");
 	EXPECT_DOUBLE_EQ(cfg.DM->mass, 10.0);
 	EXPECT_DOUBLE_EQ(cfg.DM_distr->DM_density, 0.4 * GeV / cm / cm / cm);
+	EXPECT_TRUE(cfg.DM_distr->Eta_Function_Is_Tabulated());
 	EXPECT_EQ(cfg.DM_detector->name, "Nuclear recoil");
 	EXPECT_DOUBLE_EQ(cfg.constraints_mass_min, 10.0);
 	EXPECT_DOUBLE_EQ(cfg.constraints_mass_max, 100.0);
@@ -126,3 +126,86 @@ TEST(TestImportedDMDistribution, TestPrintSummary)
 	// ASSERT
 	imported_distr.Print_Summary();
 }
+
+// 3. Tabulated version of any DM distribution
+TEST(TestTabulatedDMDistribution, TestStandardHaloModel)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	std::vector<double> vs = {100 * km / sec, 300 * km / sec, 500 * km / sec, 700 * km / sec};
+	// ACT
+	Tabulated_DM_Distribution tabulated_shm(shm, 1.0e-5);
+	// ASSERT
+	EXPECT_GT(tabulated_shm.Number_Of_Grid_Points(), 65);
+	EXPECT_TRUE(tabulated_shm.DD_use_eta_function);
+	EXPECT_EQ(tabulated_shm.DM_density, shm.DM_density);
+	EXPECT_EQ(tabulated_shm.Maximum_DM_Speed(), shm.Maximum_DM_Speed());
+	for(auto& v : vs)
+	{
+		EXPECT_NEAR(tabulated_shm.PDF_Speed(v), shm.PDF_Speed(v), 1.0e-4 * shm.PDF_Speed(v));
+		EXPECT_NEAR(tabulated_shm.CDF_Speed(v), shm.CDF_Speed(v), 1.0e-4);
+		EXPECT_NEAR(tabulated_shm.Eta_Function(v), shm.Eta_Function(v), 1.0e-3 * shm.Eta_Function(v));
+	}
+	EXPECT_NEAR(tabulated_shm.CDF_Speed(tabulated_shm.Maximum_DM_Speed()), 1.0, 1.0e-4);
+	EXPECT_EQ(tabulated_shm.Eta_Function(tabulated_shm.Maximum_DM_Speed()), 0.0);
+}
+
+// A user-derived distribution without its own Clone(), with a uniform speed distribution
+class Uniform_Speed_Distribution : public Standard_Halo_Model
+{
+  public:
+	virtual double PDF_Speed(double v) const override { return (v < Maximum_DM_Speed()) ? 1.0 / Maximum_DM_Speed() : 0.0; };
+};
+
+TEST(TestTabulatedDMDistribution, TestSharedDistribution)
+{
+	// ARRANGE
+	auto uniform_distribution = std::make_shared<Uniform_Speed_Distribution>();
+	double v				  = 300 * km / sec;
+	// ACT
+	Tabulated_DM_Distribution tabulated_distribution(uniform_distribution);
+	// ASSERT
+	EXPECT_NEAR(tabulated_distribution.PDF_Speed(v), 1.0 / uniform_distribution->Maximum_DM_Speed(), 1.0e-6 / uniform_distribution->Maximum_DM_Speed());
+	EXPECT_NEAR(tabulated_distribution.CDF_Speed(v), v / uniform_distribution->Maximum_DM_Speed(), 1.0e-4);
+}
+
+// A distribution, which only defines the velocity distribution, such that the speed pdf is the base class' angular integral
+class Velocity_Distribution : public DM_Distribution
+{
+  public:
+	Standard_Halo_Model shm;
+
+	explicit Velocity_Distribution(const Standard_Halo_Model& model)
+	: DM_Distribution("Velocity distribution", model.DM_density, model.Minimum_DM_Speed(), model.Maximum_DM_Speed()), shm(model) {};
+
+	virtual Velocity_Distribution* Clone() const override { return new Velocity_Distribution(*this); };
+	virtual double PDF_Velocity(libphysica::Vector vel) const override { return shm.PDF_Velocity(vel); };
+};
+
+TEST(TestTabulatedDMDistribution, TestAngularIntegral)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	Velocity_Distribution distribution(shm);
+	// The speed pdf has a kink at v_esc - v_obs and vanishes at v_esc + v_obs.
+	double v_kink		   = shm.Maximum_DM_Speed() - 2.0 * shm.Get_Observer_Velocity().Norm();
+	std::vector<double> vs = {100 * km / sec, v_kink - 10 * km / sec, v_kink, v_kink + 10 * km / sec, 600 * km / sec, shm.Maximum_DM_Speed() - 50 * km / sec};
+	// ACT
+	Tabulated_DM_Distribution tabulated_distribution(distribution);
+	// ASSERT
+	for(auto& v : vs)
+	{
+		EXPECT_NEAR(tabulated_distribution.PDF_Speed(v), distribution.PDF_Speed(v), 1.0e-4 * distribution.PDF_Speed(v));
+		EXPECT_NEAR(tabulated_distribution.Eta_Function(v), distribution.Eta_Function(v), 1.0e-3 * distribution.Eta_Function(v));
+		EXPECT_NEAR(tabulated_distribution.Eta_Function(v), shm.Eta_Function(v), 1.0e-2 * shm.Eta_Function(v));
+	}
+}
+
+TEST(TestTabulatedDMDistribution, TestPrintSummary)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	Tabulated_DM_Distribution tabulated_shm(shm);
+	// ACT & ASSERT
+	tabulated_shm.Print_Summary();
+}
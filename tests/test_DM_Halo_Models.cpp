@@ -1,5 +1,10 @@
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "obscura/DM_Halo_Models.hpp"
 
 #include "libphysica/Integration.hpp"
@@ -174,6 +179,75 @@ TEST(TestStandardHaloModel, TestEtaFunction)
 	EXPECT_DOUBLE_EQ(shm.Eta_Function(1.0), 0.0);
 }
 
+TEST(TestStandardHaloModel, TestEtaFunctionTabulated)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	double vMin = 300 * km / sec;
+	// ACT & ASSERT
+	EXPECT_FALSE(shm.Eta_Function_Is_Tabulated());
+	EXPECT_EQ(shm.Eta_Function_Tabulated(vMin), shm.Eta_Function(vMin));
+	shm.Tabulate_Eta_Function(2000);
+	ASSERT_TRUE(shm.Eta_Function_Is_Tabulated());
+	EXPECT_DOUBLE_EQ(shm.Eta_Function_Tabulated(shm.Minimum_DM_Speed()), shm.Eta_Function(shm.Minimum_DM_Speed()));
+	EXPECT_NEAR(shm.Eta_Function_Tabulated(vMin), shm.Eta_Function(vMin), 1.0e-5 * shm.Eta_Function(vMin));
+	EXPECT_EQ(shm.Eta_Function_Tabulated(shm.Maximum_DM_Speed()), 0.0);
+	shm.Set_Speed_Dispersion(200 * km / sec);
+	EXPECT_NEAR(shm.Eta_Function_Tabulated(vMin), shm.Eta_Function(vMin), 1.0e-5 * shm.Eta_Function(vMin));
+	shm.Clear_Eta_Table();
+	EXPECT_FALSE(shm.Eta_Function_Is_Tabulated());
+}
+
+TEST(TestStandardHaloModel, TestBatchFunctions)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	std::vector<double> vs = {0.0, 100 * km / sec, 300 * km / sec, 700 * km / sec, shm.Maximum_DM_Speed(), 1.0};
+	// ACT
+	std::vector<double> pdfs = shm.PDF_Speed(vs);
+	std::vector<double> cdfs = shm.CDF_Speed(vs);
+	std::vector<double> etas = shm.Eta_Function(vs);
+	// ASSERT
+	ASSERT_EQ(etas.size(), vs.size());
+	for(unsigned int i = 0; i < vs.size(); i++)
+	{
+		EXPECT_EQ(pdfs[i], shm.PDF_Speed(vs[i]));
+		EXPECT_EQ(cdfs[i], shm.CDF_Speed(vs[i]));
+		EXPECT_EQ(etas[i], shm.Eta_Function(vs[i]));
+	}
+}
+
+// A derived halo model, which overrides both the single-speed and the batch functions
+class Modified_Halo_Model : public Standard_Halo_Model
+{
+  public:
+	virtual double PDF_Speed(double v) const override { return 2.0 * Standard_Halo_Model::PDF_Speed(v); };
+	virtual double CDF_Speed(double v) const override { return 2.0 * Standard_Halo_Model::CDF_Speed(v); };
+	virtual double Eta_Function(double vMin) const override { return 2.0 * Standard_Halo_Model::Eta_Function(vMin); };
+	virtual std::vector<double> PDF_Speed(const std::vector<double>& vs) const override { return DM_Distribution::PDF_Speed(vs); };
+	virtual std::vector<double> CDF_Speed(const std::vector<double>& vs) const override { return DM_Distribution::CDF_Speed(vs); };
+	virtual std::vector<double> Eta_Function(const std::vector<double>& vMins) const override { return DM_Distribution::Eta_Function(vMins); };
+};
+
+TEST(TestStandardHaloModel, TestBatchFunctionsDerivedClass)
+{
+	// ARRANGE
+	Modified_Halo_Model halo_model;
+	const DM_Distribution& distribution = halo_model;
+	std::vector<double> vs				= {100 * km / sec, 300 * km / sec, 700 * km / sec};
+	// ACT
+	std::vector<double> pdfs = distribution.PDF_Speed(vs);
+	std::vector<double> cdfs = distribution.CDF_Speed(vs);
+	std::vector<double> etas = distribution.Eta_Function(vs);
+	// ASSERT
+	for(unsigned int i = 0; i < vs.size(); i++)
+	{
+		EXPECT_EQ(pdfs[i], halo_model.PDF_Speed(vs[i]));
+		EXPECT_EQ(cdfs[i], halo_model.CDF_Speed(vs[i]));
+		EXPECT_EQ(etas[i], halo_model.Eta_Function(vs[i]));
+	}
+}
+
 TEST(TestStandardHaloModel, TestPrintSummary)
 {
 	// ARRANGE
@@ -217,6 +291,62 @@ TEST(TestStandardHaloModel, TestObserverVelocity)
 	ASSERT_DOUBLE_EQ(shm.Maximum_DM_Speed(), v_Earth + vesc);
 }
 
+TEST(TestHaloEnsemble, TestEtaFunctions)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	Standard_Halo_Model shm_2(0.3 * GeV / cm / cm / cm, 250 * km / sec, 250 * km / sec, 600 * km / sec);
+	Halo_Ensemble ensemble({shm, shm_2});
+	libphysica::Vector vel_obs({0, 300 * km / sec, 0});
+	ensemble.Add_Member(0.5 * GeV / cm / cm / cm, 200 * km / sec, vel_obs, 500 * km / sec);
+	std::vector<double> vMins = {0.0, 100 * km / sec, 300 * km / sec, 700 * km / sec, 900 * km / sec};
+	// ACT
+	std::vector<std::vector<double>> etas = ensemble.Eta_Functions(vMins);
+	// ASSERT
+	ASSERT_EQ(ensemble.Number_Of_Members(), 3);
+	EXPECT_DOUBLE_EQ(ensemble.Maximum_DM_Speed(), 850 * km / sec);
+	ASSERT_EQ(etas.size(), vMins.size());
+	for(unsigned int i = 0; i < ensemble.Number_Of_Members(); i++)
+	{
+		std::shared_ptr<Standard_Halo_Model> member = ensemble.Member(i);
+		EXPECT_EQ(member->DM_density, ensemble.DM_Density(i));
+		for(unsigned int j = 0; j < vMins.size(); j++)
+			EXPECT_EQ(etas[j][i], member->Eta_Function(vMins[j]));
+	}
+	EXPECT_EQ(etas[2][1], shm_2.Eta_Function(vMins[2]));
+}
+
+TEST(TestHaloEnsemble, TestSHMplusplusMembers)
+{
+	// ARRANGE
+	Standard_Halo_Model shm;
+	SHM_Plus_Plus shmpp;
+	Halo_Ensemble ensemble;
+	ensemble.Add_Member(shm);
+	ensemble.Add_Member(shmpp);
+	libphysica::Vector vel_obs({0, 250 * km / sec, 0});
+	ensemble.Add_Member(0.5 * GeV / cm / cm / cm, 230 * km / sec, vel_obs, 550 * km / sec, 0.3, 0.9);
+	std::vector<double> vMins = {0.0, 100 * km / sec, 300 * km / sec, 700 * km / sec, 900 * km / sec};
+	// ACT
+	std::vector<std::vector<double>> etas = ensemble.Eta_Functions(vMins);
+	// ASSERT
+	ASSERT_EQ(ensemble.Number_Of_Members(), 3);
+	EXPECT_EQ(dynamic_cast<SHM_Plus_Plus*>(ensemble.Member(0).get()), nullptr);
+	for(unsigned int i = 1; i < ensemble.Number_Of_Members(); i++)
+	{
+		std::shared_ptr<Standard_Halo_Model> member = ensemble.Member(i);
+		ASSERT_NE(dynamic_cast<SHM_Plus_Plus*>(member.get()), nullptr);
+		for(unsigned int j = 0; j < vMins.size(); j++)
+			EXPECT_EQ(etas[j][i], member->Eta_Function(vMins[j]));
+	}
+	for(unsigned int j = 0; j < vMins.size(); j++)
+	{
+		EXPECT_EQ(etas[j][0], shm.Eta_Function(vMins[j]));
+		EXPECT_EQ(etas[j][1], shmpp.Eta_Function(vMins[j]));
+	}
+	EXPECT_NE(etas[1][1], shm.Eta_Function(vMins[1]));
+}
+
 // 2. Standard halo model++ (SHM++) as proposed by Evans, O'Hare and McCabe [arXiv:1810.11468]
 TEST(TestSHMplusplus, TestDefaultConstructor)
 {
@@ -382,6 +512,19 @@ TEST(TestSHMplusplus, TestEtaFunction)
 	EXPECT_DOUBLE_EQ(shmpp.Eta_Function(1.0), 0.0);
 }
 
+TEST(TestSHMplusplus, TestBatchEtaFunction)
+{
+	// ARRANGE
+	SHM_Plus_Plus shmpp;
+	const DM_Distribution& distribution = shmpp;
+	std::vector<double> vMins			= {0.0, 300 * km / sec, 600 * km / sec};
+	// ACT
+	std::vector<double> etas = distribution.Eta_Function(vMins);
+	// ASSERT
+	for(unsigned int i = 0; i < vMins.size(); i++)
+		EXPECT_EQ(etas[i], shmpp.Eta_Function(vMins[i]));
+}
+
 TEST(TestSHMplusplus, TestPrintSummary)
 {
 	// ARRANGE
@@ -406,6 +549,57 @@ TEST(TestSHMplusplus, TestSetFunctions)
 	EXPECT_NEAR(shmpp.Average_Speed(), 0.0015072180115424205, 1.0e-8);
 }
 
+TEST(TestSHMplusplus, TestEtaTableUpdate)
+{
+	// ARRANGE
+	SHM_Plus_Plus shmpp;
+	SHM_Plus_Plus shm(0.0);
+	Standard_Halo_Model shm_reference(0.55 * GeV / cm / cm / cm, 233.0 * km / sec, 240.0 * km / sec, 528.0 * km / sec);
+	double vMin = 300 * km / sec;
+	// ACT
+	double eta_1 = shmpp.Eta_Function(vMin);
+	shmpp.Set_Beta(0.5);
+	double eta_2 = shmpp.Eta_Function(vMin);
+	// ASSERT
+	EXPECT_EQ(shm.Eta_Function(vMin), shm_reference.Eta_Function(vMin));
+	EXPECT_NE(eta_1, eta_2);
+	EXPECT_EQ(SHM_Plus_Plus(0.2, 0.5).Eta_Function(vMin), eta_2);
+}
+
+TEST(TestSHMplusplus, TestEtaTableFolder)
+{
+	// ARRANGE
+	std::string folder = "Eta_Table_Test/";
+	mkdir(folder.c_str(), 0755);
+	SHM_Plus_Plus::Set_Eta_Table_Folder(folder);
+	double eta_1, eta_2;
+	// ACT
+	{
+		SHM_Plus_Plus shmpp(0.55 * GeV / cm / cm / cm, 220.0 * km / sec, 230.0 * km / sec, 550.0 * km / sec);
+		eta_1 = shmpp.Eta_Function(300 * km / sec);
+	}
+	// The first table has been freed, the second instance imports it from the file.
+	{
+		SHM_Plus_Plus shmpp(0.55 * GeV / cm / cm / cm, 220.0 * km / sec, 230.0 * km / sec, 550.0 * km / sec);
+		eta_2 = shmpp.Eta_Function(300 * km / sec);
+	}
+	SHM_Plus_Plus::Set_Eta_Table_Folder("");
+	// ASSERT
+	EXPECT_GT(eta_1, 0.0);
+	EXPECT_DOUBLE_EQ(eta_2, eta_1);
+	std::vector<std::string> files;
+	DIR* directory = opendir(folder.c_str());
+	while(dirent* entry = readdir(directory))
+		if(std::string(entry->d_name).find("Eta_S_") == 0)
+			files.push_back(entry->d_name);
+	closedir(directory);
+	EXPECT_EQ(files.size(), 1);
+	// Clean up
+	for(auto& file : files)
+		std::remove((folder + file).c_str());
+	rmdir(folder.c_str());
+}
+
 TEST(TestSHMplusplus, TestObserverVelocity)
 {
 	// ARRANGE
@@ -157,6 +157,24 @@ TEST(TestDMParticleSI, TestSetMass)
 	EXPECT_DOUBLE_EQ(dm.Sigma_Neutron(), sigma_n);
 }
 
+TEST(TestDMParticleSI, TestBatchIonizationCrossSection)
+{
+	// ARRANGE
+	DM_Particle_SI dm(100.0 * MeV);
+	dm.Set_Sigma_Electron(pb);
+	Atom xenon("Xe");
+	const Atomic_Electron& Xe_5p = xenon.Electron(5, 1);
+	std::vector<double> qs		 = {0.5 * keV, keV, 10.0 * keV, 100.0 * keV};
+	double Ee					 = 20.0 * eV;
+	double vDM					 = 1.0e-3;
+	// ACT
+	std::vector<double> cross_sections = dm.d2Sigma_dq2_dEe_Ionization(qs, Ee, vDM, Xe_5p);
+	// ASSERT
+	ASSERT_EQ(cross_sections.size(), qs.size());
+	for(unsigned int i = 0; i < qs.size(); i++)
+		EXPECT_DOUBLE_EQ(cross_sections[i], dm.d2Sigma_dq2_dEe_Ionization(qs[i], Ee, vDM, Xe_5p));
+}
+
 TEST(TestDMParticleSI, TestPrintSummary)
 {
 	// ARRANGE
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "obscura/Data_Pack.hpp"
+
+#include "libphysica/Natural_Units.hpp"
+#include "libphysica/Utilities.hpp"
+
+using namespace obscura;
+using namespace libphysica::natural_units;
+
+void Write_Text_File(const std::string& path, const std::string& content)
+{
+	std::ofstream f(path);
+	f << content;
+}
+
+void Create_Test_Data_Folder(const std::string& folder)
+{
+	mkdir(folder.c_str(), 0755);
+	mkdir((folder + "Subfolder/").c_str(), 0755);
+	Write_Text_File(folder + "Table.txt", "1.0 2.0 3.0\n4.0 5.0 6.0\n");
+	Write_Text_File(folder + "Labels.txt", "H\t1\t1\t0.99985\nHe\t2\t4\t0.99999863\n");
+	Write_Text_File(folder + "Subfolder/List.dat", "0.5\n1.5\n2.5\n");
+	Write_Text_File(folder + "Comments.txt", "# 1 2\n1.0 2.0 3.0\n#Last row\n4.0 5.0 6.0\n");
+	Write_Text_File(folder + "Mixed_Labels.txt", "H\t1\t1\n2\t4\t1\n");
+	Write_Text_File(folder + "Text.txt", "Some description of the data.\n");
+	Write_Text_File(folder + "README.md", "1 2 3\n");
+}
+
+void Remove_Test_Data_Folder(const std::string& folder)
+{
+	for(std::string file : {"Table.txt", "Labels.txt", "Subfolder/List.dat", "Comments.txt", "Mixed_Labels.txt", "Text.txt", "README.md", "test.pack", "corrupted.pack", "modified.pack"})
+		std::remove((folder + file).c_str());
+	rmdir((folder + "Subfolder/").c_str());
+	rmdir(folder.c_str());
+}
+
+//1. Binary data pack
+TEST(TestDataPack, TestCreateDataPack)
+{
+	// ARRANGE
+	std::string folder = "Data_Pack_Test_1/";
+	Create_Test_Data_Folder(folder);
+	// ACT
+	unsigned int tables = Create_Data_Pack(folder, folder + "test.pack");
+	Data_Pack pack(folder + "test.pack");
+	// ASSERT
+	EXPECT_EQ(tables, 4);
+	ASSERT_TRUE(pack.Is_Open());
+	EXPECT_EQ(pack.Number_Of_Tables(), 4);
+	EXPECT_EQ(pack.Keys(), std::vector<std::string>({"Comments.txt", "Labels.txt", "Subfolder/List.dat", "Table.txt"}));
+	EXPECT_FALSE(pack.Contains("Mixed_Labels.txt"));
+	EXPECT_FALSE(pack.Contains("Text.txt"));
+	EXPECT_FALSE(pack.Contains("README.md"));
+	// Clean up
+	Remove_Test_Data_Folder(folder);
+}
+
+TEST(TestDataPack, TestImportTable)
+{
+	// ARRANGE
+	std::string folder = "Data_Pack_Test_2/";
+	Create_Test_Data_Folder(folder);
+	Create_Data_Pack(folder, folder + "test.pack");
+	Data_Pack pack(folder + "test.pack");
+	std::vector<std::vector<double>> table, labels, list, comments;
+	// ACT & ASSERT
+	ASSERT_TRUE(pack.Import_Table("Comments.txt", comments));
+	ASSERT_TRUE(pack.Import_Table("Table.txt", table));
+	ASSERT_TRUE(pack.Import_Table("Labels.txt", labels));
+	ASSERT_TRUE(pack.Import_Table("Subfolder/List.dat", list));
+	EXPECT_EQ(table, std::vector<std::vector<double>>({{1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}}));
+	EXPECT_EQ(labels, std::vector<std::vector<double>>({{1.0, 1.0, 0.99985}, {2.0, 4.0, 0.99999863}}));
+	EXPECT_EQ(list, std::vector<std::vector<double>>({{0.5}, {1.5}, {2.5}}));
+	EXPECT_EQ(comments, table);
+	EXPECT_FALSE(pack.Import_Table("Missing.txt", table));
+	// Clean up
+	Remove_Test_Data_Folder(folder);
+}
+
+TEST(TestDataPack, TestModifiedSourceFile)
+{
+	// ARRANGE
+	std::string folder = "Data_Pack_Test_3/";
+	Create_Test_Data_Folder(folder);
+	Create_Data_Pack(folder, folder + "test.pack");
+	Data_Pack pack(folder + "test.pack");
+	// ACT
+	Write_Text_File(folder + "Table.txt", "1.0 2.0 3.0\n4.0 5.0 6.0\n7.0 8.0 9.0\n");
+	// ASSERT
+	EXPECT_FALSE(pack.Contains("Table.txt"));
+	EXPECT_TRUE(pack.Contains("Labels.txt"));
+	// Clean up
+	Remove_Test_Data_Folder(folder);
+}
+
+TEST(TestDataPack, TestInvalidDataPack)
+{
+	// ARRANGE
+	std::string folder = "Data_Pack_Test_4/";
+	Create_Test_Data_Folder(folder);
+	Create_Data_Pack(folder, folder + "test.pack");
+	Write_Text_File(folder + "corrupted.pack", "This is not a data pack, but it is long enough to contain a header.");
+	std::string content;
+	{
+		std::ifstream f(folder + "test.pack", std::ios::binary);
+		content = std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	}
+	content[48] ^= 0x01;	// Flip a bit of the first table entry
+	Write_Text_File(folder + "modified.pack", content);
+	// ACT
+	Data_Pack missing_pack(folder + "missing.pack");
+	Data_Pack corrupted_pack(folder + "corrupted.pack");
+	Data_Pack modified_pack(folder + "modified.pack");
+	// ASSERT
+	EXPECT_FALSE(missing_pack.Is_Open());
+	EXPECT_FALSE(corrupted_pack.Is_Open());
+	ASSERT_TRUE(modified_pack.Is_Open());
+	EXPECT_EQ(modified_pack.Number_Of_Tables(), 3);
+	EXPECT_FALSE(modified_pack.Contains("Comments.txt"));
+	EXPECT_TRUE(modified_pack.Contains("Labels.txt"));
+	EXPECT_TRUE(modified_pack.Contains("Table.txt"));
+	// Clean up
+	Remove_Test_Data_Folder(folder);
+}
+
+//2. Import functions
+TEST(TestDataPack, TestImportDataTable)
+{
+	// ARRANGE
+	std::string path = PROJECT_DIR "data/XENON10e/PE_Trigger_Efficiency.txt";
+	// ACT & ASSERT
+	EXPECT_EQ(Import_Data_List(path), libphysica::Import_List(path));
+	EXPECT_EQ(Import_Data_Table(path, {keV}), libphysica::Import_Table(path, {keV}));
+}
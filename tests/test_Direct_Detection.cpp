@@ -1,6 +1,9 @@
 #include "obscura/Direct_Detection.hpp"
 #include "gtest/gtest.h"
 
+#include <cmath>
+#include <thread>
+
 #include "libphysica/Natural_Units.hpp"
 #include "libphysica/Utilities.hpp"
 
@@ -41,6 +44,135 @@ TEST(TestDirectDetection, TestEnergyBins)
 	ASSERT_GT(limit_2, limit_1);
 }
 
+TEST(TestDirectDetection, TestEnergyBinsMultipleDetectors)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	dm.Set_Sigma_Proton(1e-40 * cm * cm);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_1("test 1", kg * year, {oxygen});
+	detector_1.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	DM_Detector_Nucleus detector_2("test 2", 2.0 * kg * year, {oxygen});
+	detector_2.Use_Energy_Bins(0.5 * keV, 100.0 * keV, 3);
+	detector_2.Set_Bin_Efficiencies({0.5, 1.0, 1.0});
+	double error;
+	std::vector<double> bins_1 = {1.0 * keV, 3.0 * keV, 5.0 * keV, 7.0 * keV, 9.0 * keV, 11.0 * keV};
+	std::vector<double> bins_2 = {0.5 * keV, 33.666666666666666 * keV, 66.83333333333333 * keV, 100.0 * keV};
+	// ACT
+	std::vector<std::vector<double>> signals = DM_Detector::DM_Signals_Energy_Bins({&detector_1, &detector_2}, dm, shm);
+	// ASSERT
+	ASSERT_EQ(signals.size(), 2);
+	ASSERT_EQ(signals[0].size(), 5);
+	ASSERT_EQ(signals[1].size(), 3);
+	for(unsigned int i = 0; i < 5; i++)
+	{
+		double reference = kg * year * detector_1.Integrate_dRdE(bins_1[i], bins_1[i + 1], dm, shm, error);
+		EXPECT_NEAR(signals[0][i], reference, 1.0e-3 * reference);
+	}
+	double efficiencies[3] = {0.5, 1.0, 1.0};
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		double reference = efficiencies[i] * 2.0 * kg * year * detector_2.Integrate_dRdE(bins_2[i], bins_2[i + 1], dm, shm, error);
+		EXPECT_NEAR(signals[1][i], reference, 1.0e-3 * reference + 1.0e-10);
+	}
+	// Beyond the kinematic endpoint
+	EXPECT_EQ(signals[1][2], 0.0);
+	std::vector<double> signals_1 = detector_1.DM_Signals_Binned(dm, shm);
+	for(unsigned int i = 0; i < 5; i++)
+		EXPECT_NEAR(signals_1[i], signals[0][i], 1.0e-3 * signals[0][i]);
+}
+
+TEST(TestDirectDetection, TestEnergyBinsDifferentNuclei)
+{
+	// ARRANGE
+	auto xenon	= Get_Nucleus(54);
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(10.0 * GeV);
+	dm.Set_Sigma_Proton(1e-40 * cm * cm);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_1("xenon", kg * year, {xenon});
+	detector_1.Use_Energy_Bins(1.0 * keV, 11.0 * keV, 5);
+	DM_Detector_Nucleus detector_2("oxygen", kg * year, {oxygen});
+	detector_2.Use_Energy_Bins(1.0 * keV, 31.0 * keV, 3);
+	std::vector<DM_Detector_Nucleus*> detectors = {&detector_1, &detector_2};
+	double error;
+	std::vector<std::vector<double>> bins = {{1.0 * keV, 3.0 * keV, 5.0 * keV, 7.0 * keV, 9.0 * keV, 11.0 * keV}, {1.0 * keV, 11.0 * keV, 21.0 * keV, 31.0 * keV}};
+	// ACT
+	std::vector<std::vector<double>> signals = DM_Detector::DM_Signals_Energy_Bins({&detector_1, &detector_2}, dm, shm);
+	// ASSERT
+	ASSERT_EQ(signals.size(), 2);
+	for(unsigned int d = 0; d < 2; d++)
+	{
+		// The spectrum accuracy refers to each bin, including the tail bins. The oxygen spectrum extends beyond the kinematic endpoint of xenon.
+		for(unsigned int i = 0; i + 1 < bins[d].size(); i++)
+		{
+			double reference = kg * year * detectors[d]->Integrate_dRdE(bins[d][i], bins[d][i + 1], dm, shm, error);
+			ASSERT_GT(reference, 0.0);
+			EXPECT_NEAR(signals[d][i], reference, 1.0e-3 * reference);
+		}
+	}
+}
+
+TEST(TestDirectDetection, TestIntegratedRdE)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(1.0 * GeV);
+	dm.Set_Sigma_Proton(1e-40 * cm * cm);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(0.05 * keV, 20 * keV);
+	std::vector<double> energies = libphysica::Log_Space(0.05 * keV, 1.0 * keV, 20001);
+	double integral				 = 0.0;
+	for(unsigned int i = 1; i < energies.size(); i++)
+		integral += (energies[i] - energies[i - 1]) * (detector.dRdE(energies[i], dm, shm) + detector.dRdE(energies[i - 1], dm, shm)) / 2.0;
+	double error;
+	// ACT
+	double result = detector.Integrate_dRdE(0.05 * keV, 20 * keV, dm, shm, error);
+	// ASSERT
+	EXPECT_NEAR(result, integral, 1.0e-3 * integral);
+	EXPECT_GT(error, 0.0);
+	EXPECT_LT(error, 1.0e-3 * result);
+	EXPECT_DOUBLE_EQ(detector.DM_Signals_Total(dm, shm), kg * year * result);
+	EXPECT_EQ(detector.Integrate_dRdE(5.0 * keV, 20 * keV, dm, shm, error), 0.0);
+	EXPECT_EQ(error, 0.0);
+}
+
+// Detector without a kinematic endpoint, whose spectrum is either flat or oscillates too fast for the adaptive sampling to converge.
+class Test_Detector : public DM_Detector
+{
+  public:
+	bool oscillating;
+	mutable unsigned int evaluations;
+
+	Test_Detector(bool oscill)
+	: DM_Detector("test", kg * year, "test targets"), oscillating(oscill), evaluations(0) {};
+
+	virtual double dRdE(double E, const DM_Particle& DM, const DM_Distribution& DM_distr) const override
+	{
+		evaluations++;
+		return oscillating ? (1.0 + sin(1.0e6 * E / keV)) / keV : 1.0 / keV;
+	};
+};
+
+TEST(TestDirectDetection, TestIntegratedRdEBaseClass)
+{
+	// ARRANGE
+	DM_Particle_SI dm(10.0 * GeV);
+	Standard_Halo_Model shm;
+	Test_Detector detector(false);
+	detector.Use_Energy_Threshold(1.0 * keV, 11.0 * keV);
+	Test_Detector oscillating_detector(true);
+	oscillating_detector.Set_Spectrum_Accuracy(1.0e-12);
+	double error;
+	// ACT & ASSERT
+	EXPECT_NEAR(detector.DM_Signals_Total(dm, shm), 10.0 * kg * year, 1.0e-10 * kg * year);
+	EXPECT_GT(oscillating_detector.Integrate_dRdE(1.0 * keV, 11.0 * keV, dm, shm, error), 0.0);
+	EXPECT_GT(error, 0.0);
+	EXPECT_LE(oscillating_detector.evaluations, 10000);
+}
+
 TEST(TestDirectDetection, TestPValue)
 {
 	// ARRANGE
@@ -62,6 +194,128 @@ TEST(TestDirectDetection, TestPValue)
 	ASSERT_LT(detector.P_Value(dm, shm), 1.0 - CL);
 }
 
+TEST(TestDirectDetection, TestPValueBinnedPoisson)
+{
+	// ARRANGE
+	double CL	= 0.9;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+	detector.Set_Observed_Events({5, 3, 1, 0});
+	detector.Set_Expected_Background({2.0, 1.0, 0.5, 0.1});
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	ASSERT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1e-6);
+	dm.Set_Interaction_Parameter(0.9 * limit, "Nuclei");
+	ASSERT_GT(detector.P_Value(dm, shm), 1.0 - CL);
+	dm.Set_Interaction_Parameter(1.1 * limit, "Nuclei");
+	ASSERT_LT(detector.P_Value(dm, shm), 1.0 - CL);
+}
+
+TEST(TestDirectDetection, TestPValueMaximumGap)
+{
+	// ARRANGE
+	double CL	= 0.9;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Maximum_Gap({1.0 * keV, 2.0 * keV, 5.0 * keV, 8.0 * keV, 20.0 * keV});
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	ASSERT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1e-4);
+	dm.Set_Interaction_Parameter(0.5 * limit, "Nuclei");
+	ASSERT_GT(detector.P_Value(dm, shm), 1.0 - CL);
+	dm.Set_Interaction_Parameter(2.0 * limit, "Nuclei");
+	ASSERT_LT(detector.P_Value(dm, shm), 1.0 - CL);
+}
+
+TEST(TestDirectDetection, TestCDFMaximumGap)
+{
+	// ARRANGE
+	double mu = 3.0;
+	// ACT & ASSERT
+	EXPECT_DOUBLE_EQ(CDF_Maximum_Gap(mu, mu), 1.0 - exp(-mu));
+	EXPECT_NEAR(CDF_Maximum_Gap(2.0, mu), 1.0 - 2.0 * exp(-2.0), 1.0e-12);
+	EXPECT_NEAR(CDF_Maximum_Gap(1.5, mu), 1.0 - 2.5 * exp(-1.5), 1.0e-12);
+	EXPECT_EQ(CDF_Maximum_Gap(0.0, mu), 0.0);
+	// Reference values of the series evaluated with 400 significant digits
+	std::vector<std::vector<double>> references = {{2.5, 40.0, 1.665122775098251e-02}, {10.0, 1000.0, 9.559863271309209e-01}, {1.0, 300.0, 1.029640044482403e-130}, {2.0, 500.0, 1.014282505061943e-44}, {0.5, 60.0, 9.647026301680335e-92}};
+	for(auto& reference : references)
+		EXPECT_NEAR(CDF_Maximum_Gap(reference[0], reference[1]), reference[2], 1.0e-6 * reference[2]);
+}
+
+TEST(TestDirectDetection, TestUpperLimitCurveMultithreaded)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	auto masses = libphysica::Log_Space(0.5, 100, 6);
+	// ACT
+	auto limits_serial	 = detector.Upper_Limit_Curve(dm, shm, masses, 0.9);
+	auto limits_parallel = detector.Upper_Limit_Curve(dm, shm, masses, 0.9, 4);
+	// ASSERT
+	ASSERT_DOUBLE_EQ(dm.mass, 100.0 * GeV);
+	ASSERT_EQ(limits_parallel.size(), limits_serial.size());
+	for(unsigned int i = 0; i < limits_serial.size(); i++)
+	{
+		EXPECT_DOUBLE_EQ(limits_parallel[i][0], limits_serial[i][0]);
+		EXPECT_DOUBLE_EQ(limits_parallel[i][1], limits_serial[i][1]);
+	}
+}
+
+TEST(TestDirectDetection, TestConcurrentEvaluation)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV, 1e-45 * cm * cm);
+	const Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector_nucleus("test", kg * year, {oxygen});
+	detector_nucleus.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	const DM_Detector& detector = detector_nucleus;
+	auto masses					= libphysica::Log_Space(5.0, 100, 8);
+	auto evaluate				= [&detector, &shm, &masses](DM_Particle& DM) {
+		  std::vector<double> results;
+		  for(auto& mass : masses)
+		  {
+			  DM.Set_Mass(mass);
+			  results.push_back(detector.dRdE(2.0 * keV, DM, shm));
+			  results.push_back(detector.DM_Signals_Total(DM, shm));
+			  results.push_back(detector.Log_Likelihood(DM, shm));
+			  results.push_back(detector.P_Value(DM, shm));
+		  }
+		  return results;
+	};
+	std::vector<double> results_serial = evaluate(dm);
+	// ACT
+	unsigned int threads = 8;
+	std::vector<std::vector<double>> results_parallel(threads);
+	std::vector<std::thread> pool;
+	for(unsigned int t = 0; t < threads; t++)
+		pool.emplace_back([&evaluate, &results_parallel, &dm, t]() {
+			DM_Particle_SI dm_copy(dm);
+			results_parallel[t] = evaluate(dm_copy);
+		});
+	for(auto& thread : pool)
+		thread.join();
+	// ASSERT
+	for(auto& results : results_parallel)
+	{
+		ASSERT_EQ(results.size(), results_serial.size());
+		for(unsigned int i = 0; i < results.size(); i++)
+			EXPECT_EQ(results[i], results_serial[i]);
+	}
+}
+
 TEST(TestDirectDetection, TestLikelihoods)
 {
 	// ARRANGE
@@ -100,6 +354,45 @@ TEST(TestDirectDetection, TestLogLikelihoodsBinnedPoisson)
 	ASSERT_DOUBLE_EQ(detector.Log_Likelihood(dm, shm), log(detector.Likelihood(dm, shm)));
 }
 
+TEST(TestDirectDetection, TestHaloResponseMatrix)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	dm.Set_Sigma_Proton(1e-45 * cm * cm);
+	Standard_Halo_Model shm;
+	Standard_Halo_Model shm_2(0.3 * GeV / cm / cm / cm, 250 * km / sec, 250 * km / sec, 600 * km / sec);
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Bins(2.0 * keV, 10.0 * keV, 4);
+	detector.Set_Observed_Events({5, 3, 1, 0});
+	std::vector<double> vMin_grid = libphysica::Linear_Space(0.0, 900 * km / sec, 901);
+	// ACT
+	Halo_Response_Matrix response_matrix = detector.Compute_Halo_Response_Matrix(dm, vMin_grid);
+	// ASSERT
+	ASSERT_EQ(response_matrix.matrix.size(), 4);
+	ASSERT_EQ(response_matrix.matrix[0].size(), vMin_grid.size());
+	// Reference signals beyond the accuracy of the matrix's ramp responses
+	detector.Set_Spectrum_Accuracy(1.0e-8);
+	for(auto& halo : std::vector<Standard_Halo_Model>({shm, shm_2}))
+	{
+		std::vector<double> signals			 = detector.DM_Signals_Binned(dm, halo);
+		std::vector<double> signals_response = response_matrix.DM_Signals(halo);
+		for(unsigned int i = 0; i < signals.size(); i++)
+			EXPECT_NEAR(signals_response[i], signals[i], 1.0e-5 * signals[i]);
+		EXPECT_NEAR(detector.Log_Likelihood(response_matrix, halo), detector.Log_Likelihood(dm, halo), 1.0e-3);
+	}
+	DM_Detector_Nucleus detector_threshold("test", kg * year, {oxygen});
+	detector_threshold.Use_Energy_Threshold(2.0 * keV, 10.0 * keV);
+	Halo_Response_Matrix response_matrix_threshold = detector_threshold.Compute_Halo_Response_Matrix(dm, vMin_grid);
+	detector_threshold.Set_Spectrum_Accuracy(1.0e-8);
+	for(auto& halo : std::vector<Standard_Halo_Model>({shm, shm_2}))
+		EXPECT_NEAR(response_matrix_threshold.DM_Signals(halo)[0], detector_threshold.DM_Signals_Total(dm, halo), 1.0e-5 * detector_threshold.DM_Signals_Total(dm, halo));
+	std::vector<std::vector<double>> ensemble_signals = response_matrix.DM_Signals(Halo_Ensemble({shm, shm_2}));
+	ASSERT_EQ(ensemble_signals.size(), 2);
+	EXPECT_EQ(ensemble_signals[0], response_matrix.DM_Signals(shm));
+	EXPECT_EQ(ensemble_signals[1], response_matrix.DM_Signals(shm_2));
+}
+
 TEST(TestDirectDetection, TestLikelihoodScan)
 {
 	// ARRANGE
@@ -123,12 +416,41 @@ TEST(TestDirectDetection, TestLikelihoodScan)
 			dm.Set_Interaction_Parameter(c, "Nuclei");
 			EXPECT_DOUBLE_EQ(m, grid[i][0]);
 			EXPECT_DOUBLE_EQ(c, grid[i][1]);
-			EXPECT_DOUBLE_EQ(detector.Log_Likelihood(dm, shm), grid[i++][2]);
+			double llh = detector.Log_Likelihood(dm, shm);
+			EXPECT_NEAR(llh, grid[i++][2], 1.0e-10 * std::fabs(llh));
 		}
 }
+
+TEST(TestDirectDetection, TestLikelihoodScanStreamedMultithreaded)
+{
+	// ARRANGE
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Energy_Threshold(1.0 * keV, 20 * keV);
+	auto masses	   = libphysica::Log_Space(10, 100, 7);
+	auto couplings = libphysica::Log_Space(1e-40 * cm * cm, 1e-30 * cm * cm, 10);
+	auto grid	   = detector.Log_Likelihood_Scan(dm, shm, masses, couplings);
+	// ACT
+	std::vector<std::vector<double>> rows;
+	unsigned int calls = 0;
+	detector.Log_Likelihood_Scan(
+		dm, shm, masses, couplings, [&rows, &calls](const std::vector<std::vector<double>>& mass_rows) {
+			calls++;
+			rows.insert(rows.end(), mass_rows.begin(), mass_rows.end());
+		},
+		3);
+	// ASSERT
+	ASSERT_EQ(calls, masses.size());
+	ASSERT_EQ(rows.size(), grid.size());
+	for(unsigned int i = 0; i < grid.size(); i++)
+		for(unsigned int j = 0; j < 3; j++)
+			EXPECT_EQ(rows[i][j], grid[i][j]);
+}
 // auto masses			= libphysica::Log_Space(10.0 * MeV, 1.0, 5);
 // auto cross_sections = libphysica::Log_Space(1e-47 * cm * cm, 1e-37 * cm * cm, 10);
 // auto llhs			= cfg.DM_detector->Log_Likelihood_Scan(*cfg.DM, *cfg.DM_distr, masses, cross_sections);
 // std::cout << llhs.size() << std::endl;
 // for(auto& entry : llhs)
-// 	std::cout << entry[0] / MeV << "\t" << entry[1] / cm / cm << "\t" << entry[2] << std::endl;
\ No newline at end of file
+// 	std::cout << entry[0] / MeV << "\t" << entry[1] / cm / cm << "\t" << entry[2] << std::endl;
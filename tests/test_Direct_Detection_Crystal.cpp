@@ -61,6 +61,24 @@ TEST(TestDirectDetectionCrystal, TestRtotal)
 	EXPECT_NEAR(R_total_Crystal(Q_thr, DM, shm, target), sum, 1e-3 * sum);
 }
 
+TEST(TestDirectDetectionCrystal, TestdRdEeSpectrum)
+{
+	// ARRANGE
+	DM_Particle_SI DM(100.0 * MeV);
+	DM.Set_Interaction_Parameter(1e-36 * cm * cm, "Electrons");
+	Standard_Halo_Model shm;
+	Crystal target("Si");
+	// ACT
+	std::vector<double> spectrum = dRdEe_Crystal_Spectrum(DM, shm, target);
+	// ASSERT
+	ASSERT_EQ(spectrum.size(), target.N_E);
+	for(unsigned int Ei = 0; Ei < target.N_E; Ei += 25)
+		EXPECT_DOUBLE_EQ(spectrum[Ei], dRdEe_Crystal((Ei + 1) * target.dE, DM, shm, target));
+	for(int Q = 1; Q < 5; Q++)
+		EXPECT_DOUBLE_EQ(R_Q_Crystal(Q, spectrum, target), R_Q_Crystal(Q, DM, shm, target));
+	EXPECT_DOUBLE_EQ(R_total_Crystal(2, spectrum, target), R_total_Crystal(2, DM, shm, target));
+}
+
 TEST(TestDirectDetectionCrystal, TestDefaultConstructor)
 {
 	// ARRANGE
@@ -3,6 +3,7 @@
 #include "obscura/Direct_Detection_ER.hpp"
 
 #include "libphysica/Natural_Units.hpp"
+#include "libphysica/Utilities.hpp"
 
 #include "obscura/DM_Halo_Models.hpp"
 #include "obscura/DM_Particle_Standard.hpp"
@@ -75,4 +76,30 @@ TEST(TestDirectDetectionER, TestdRdEIonization)
 	Nucleus nucleus = Get_Nucleus(54);
 	// ACT & ASSERT
 	ASSERT_EQ(detector.dRdE_Ionization(E, DM, shm, nucleus, Xe_5p), dRdEe_Ionization_ER(E, DM, shm, nucleus.Average_Nuclear_Mass(), Xe_5p));
-}
\ No newline at end of file
+}
+TEST(TestDirectDetectionER, TestHaloResponseMatrix)
+{
+	// ARRANGE
+	DM_Particle_SI DM(100.0 * MeV);
+	DM.Set_Interaction_Parameter(1e-36 * cm * cm, "Electrons");
+	Standard_Halo_Model shm;
+	Standard_Halo_Model shm_2(0.3 * GeV / cm / cm / cm, 250 * km / sec, 250 * km / sec, 600 * km / sec);
+	DM_Detector_Ionization_ER detector("test", kg * year, "Xe");
+	detector.Use_Electron_Bins(3, 4);
+	std::vector<double> vMin_grid = libphysica::Linear_Space(0.0, 900 * km / sec, 301);
+	// ACT
+	Halo_Response_Matrix response_matrix = detector.Compute_Halo_Response_Matrix(DM, vMin_grid);
+	// ASSERT
+	ASSERT_EQ(response_matrix.matrix.size(), 4);
+	ASSERT_EQ(response_matrix.matrix[0].size(), vMin_grid.size());
+	for(auto& halo : std::vector<Standard_Halo_Model>({shm, shm_2}))
+	{
+		std::vector<double> signals			 = detector.DM_Signals_Binned(DM, halo);
+		std::vector<double> signals_response = response_matrix.DM_Signals(halo);
+		for(unsigned int i = 0; i < signals.size(); i++)
+		{
+			EXPECT_GT(signals[i], 0.0);
+			EXPECT_NEAR(signals_response[i], signals[i], 1.0e-3 * signals[i]);
+		}
+	}
+}
@@ -90,6 +90,46 @@ TEST(TestDirectDetectionIonization, TestRneBins)
 		ASSERT_GE(entry, 0.0);
 }
 
+TEST(TestDirectDetectionIonization, TestElectronSpectrum)
+{
+	// ARRANGE
+	DM_Detector_Ionization_ER detector = XENON10_S2_ER();
+	DM_Particle_SI dm(0.5);
+	dm.Set_Interaction_Parameter(pb, "Electrons");
+	Standard_Halo_Model shm;
+	unsigned int ne_max = 15;
+	// ACT
+	std::vector<double> spectrum = detector.Electron_Spectrum(ne_max, dm, shm);
+	// ASSERT
+	ASSERT_EQ(spectrum.size(), ne_max);
+	for(unsigned int ne = 1; ne <= ne_max; ne++)
+		EXPECT_NEAR(spectrum[ne - 1], detector.R_ne(ne, dm, shm), 1.0e-12 * spectrum[0]);
+}
+
+TEST(TestDirectDetectionIonization, TestPEResponseMatrix)
+{
+	// ARRANGE
+	double exposure = kg * year;
+	DM_Detector_Ionization_ER detector("S2 experiment", exposure, "Xe");
+	detector.Use_PE_Bins(20.0, 7.0, {10, 30, 60, 100}, 20);
+	DM_Particle_SI dm(0.5);
+	dm.Set_Interaction_Parameter(pb, "Electrons");
+	Standard_Halo_Model shm;
+	std::vector<unsigned int> bin_ranges = {10, 30, 60, 100};
+	// ACT
+	std::vector<double> signals = detector.DM_Signals_Binned(dm, shm);
+	// ASSERT
+	ASSERT_EQ(signals.size(), 3);
+	for(unsigned int bin = 0; bin < signals.size(); bin++)
+	{
+		double R_bin = 0.0;
+		for(unsigned int PE = bin_ranges[bin]; PE < bin_ranges[bin + 1]; PE++)
+			R_bin += detector.R_S2(PE, dm, shm);
+		EXPECT_GT(signals[bin], 0.0);
+		EXPECT_NEAR(signals[bin], exposure * R_bin, 1.0e-10 * signals[bin]);
+	}
+}
+
 TEST(TestDirectDetectionIonization, TestDMSignalsTotal)
 {
 	// ARRANGE
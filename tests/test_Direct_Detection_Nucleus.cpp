@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include "libphysica/Natural_Units.hpp"
+#include "libphysica/Utilities.hpp"
 
 #include "obscura/DM_Halo_Models.hpp"
 #include "obscura/DM_Particle_Standard.hpp"
@@ -136,6 +137,52 @@ TEST(TestDirectDetectionNucleus, dRdE)
 	ASSERT_DOUBLE_EQ(detector.dRdE(ER, DM, SHM), dRdER_Nucleus(ER, DM, SHM, Isotope(8, 16)));
 }
 
+TEST(TestDirectDetectionNucleus, dRdEMultipleIsotopes)
+{
+	// ARRANGE
+	double exposure				 = 1.0 * kg * day;
+	std::vector<Nucleus> targets = {Get_Nucleus(20), Get_Nucleus(74), Get_Nucleus(8)};
+	DM_Detector_Nucleus detector("CaWO4", exposure, targets, {1, 1, 4});
+	DM_Particle_SI DM(5.0 * GeV);
+	DM.Set_Sigma_Proton(1.0 * pb);
+	Standard_Halo_Model SHM;
+	std::vector<double> energies = libphysica::Log_Space(0.1 * keV, 50.0 * keV, 25);
+	double M_total				 = Get_Nucleus(20).Average_Nuclear_Mass() + Get_Nucleus(74).Average_Nuclear_Mass() + 4.0 * Get_Nucleus(8).Average_Nuclear_Mass();
+	// ACT
+	std::vector<double> spectrum = detector.dRdE(energies, DM, SHM);
+	// ASSERT
+	ASSERT_EQ(spectrum.size(), energies.size());
+	for(unsigned int i = 0; i < energies.size(); i++)
+	{
+		double reference = 0.0;
+		for(unsigned int j = 0; j < targets.size(); j++)
+			reference += ((j == 2) ? 4.0 : 1.0) * targets[j].Average_Nuclear_Mass() / M_total * dRdER_Nucleus(energies[i], DM, SHM, targets[j]);
+		EXPECT_NEAR(spectrum[i], reference, 1.0e-12 * reference);
+		EXPECT_DOUBLE_EQ(spectrum[i], detector.dRdE(energies[i], DM, SHM));
+	}
+}
+
+TEST(TestDirectDetectionNucleus, dRdEResolution)
+{
+	// ARRANGE
+	double exposure				 = 1.0 * kg * day;
+	std::vector<Nucleus> targets = {Get_Nucleus(8), Get_Nucleus(20)};
+	DM_Detector_Nucleus detector("Test", exposure, targets, {4, 1});
+	detector.Use_Energy_Threshold(30.0 * eV, 2.0 * keV);
+	detector.Set_Resolution(4.6 * eV);
+	DM_Particle_SI DM(1.0 * GeV);
+	DM.Set_Sigma_Proton(1.0 * pb);
+	DM.Set_Low_Mass_Mode(true);
+	Standard_Halo_Model SHM;
+	std::vector<double> energies = {20.0 * eV, 30.0 * eV, 100.0 * eV, 0.3 * keV, 0.6 * keV};
+	// ACT
+	std::vector<double> spectrum = detector.dRdE(energies, DM, SHM);
+	// ASSERT
+	ASSERT_EQ(spectrum.size(), energies.size());
+	for(unsigned int i = 0; i < energies.size(); i++)
+		EXPECT_NEAR(spectrum[i], detector.dRdE(energies[i], DM, SHM), 1.0e-3 * detector.dRdE(energies[i], DM, SHM));
+}
+
 TEST(TestDirectDetectionNucleus, PrintSummary)
 {
 	// ARRANGE
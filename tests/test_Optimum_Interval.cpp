@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "obscura/Optimum_Interval.hpp"
+
+#include "libphysica/Natural_Units.hpp"
+#include "libphysica/Utilities.hpp"
+
+#include "obscura/DM_Halo_Models.hpp"
+#include "obscura/DM_Particle_Standard.hpp"
+#include "obscura/Direct_Detection_Nucleus.hpp"
+#include "obscura/Target_Nucleus.hpp"
+
+using namespace obscura;
+using namespace libphysica::natural_units;
+
+std::string Read_Binary_File(const std::string& path)
+{
+	std::ifstream f(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+//1. Optimum interval method
+TEST(TestOptimumInterval, TestOptimumIntervalMaxima)
+{
+	// ARRANGE
+	std::vector<double> gaps = {1.0, 2.0, 3.0, 0.5};
+	// ACT
+	std::vector<double> maxima = Optimum_Interval_Maxima(gaps, 4);
+	// ASSERT
+	EXPECT_EQ(maxima, std::vector<double>({3.0, 5.0, 6.0, 6.5, 6.5}));
+}
+
+TEST(TestOptimumInterval, TestCreateTable)
+{
+	// ARRANGE
+	std::vector<double> mu_grid = {0.5, 1.0, 3.0, 10.0};
+	// ACT
+	bool success_1 = Create_Optimum_Interval_Table(mu_grid, 5, 3000, 51, 1, 7, "test_1.table");
+	bool success_2 = Create_Optimum_Interval_Table(mu_grid, 5, 3000, 51, 3, 7, "test_2.table");
+	Optimum_Interval_Table table("test_1.table");
+	// ASSERT
+	ASSERT_TRUE(success_1 && success_2);
+	EXPECT_EQ(Read_Binary_File("test_1.table"), Read_Binary_File("test_2.table"));
+	ASSERT_TRUE(table.Is_Open());
+	EXPECT_DOUBLE_EQ(table.Minimum_Mu(), 0.5);
+	EXPECT_DOUBLE_EQ(table.Maximum_Mu(), 10.0);
+	EXPECT_EQ(table.Maximum_Interval_Events(), 5);
+	// Clean up
+	std::remove("test_1.table");
+	std::remove("test_2.table");
+}
+
+TEST(TestOptimumInterval, TestPValue)
+{
+	// ARRANGE
+	Create_Optimum_Interval_Table({0.5, 1.0, 3.0, 10.0}, 5, 5000, 101, 0, 1, "test.table");
+	Optimum_Interval_Table table("test.table");
+	std::vector<double> gaps = {0.5, 0.1, 1.0, 0.4};
+	// ACT & ASSERT
+	ASSERT_TRUE(table.Is_Open());
+	// Outside the grid: maximum gap
+	EXPECT_FALSE(table.Covers(0.3));
+	EXPECT_FALSE(table.Covers(20.0));
+	EXPECT_TRUE(table.Covers(2.0));
+	EXPECT_NEAR(table.P_Value({0.3}), exp(-0.3), 1.0e-12);
+	EXPECT_NEAR(table.P_Value({20.0}), exp(-20.0), 1.0e-12);
+	// No events: Only slightly weaker than the maximum gap p-value exp(-mu), due to the choice of the optimum interval.
+	EXPECT_GT(table.P_Value({2.0}), exp(-2.0) - 0.01);
+	EXPECT_LT(table.P_Value({2.0}), 2.0 * exp(-2.0));
+	double p_value = table.P_Value(gaps);
+	EXPECT_GT(p_value, 0.0);
+	EXPECT_LT(p_value, 1.0);
+	for(auto& gap : gaps)
+		gap *= 3.0;
+	EXPECT_LT(table.P_Value(gaps), p_value);
+	// Clean up
+	std::remove("test.table");
+}
+
+TEST(TestOptimumInterval, TestUpperLimit)
+{
+	// ARRANGE
+	Create_Optimum_Interval_Table(libphysica::Log_Space(0.1, 100.0, 31), 10, 5000, 101, 0, 1, "test_limit.table");
+	double CL	= 0.9;
+	auto oxygen = Get_Nucleus(8);
+	DM_Particle_SI dm(100.0 * GeV);
+	Standard_Halo_Model shm;
+	DM_Detector_Nucleus detector("test", kg * year, {oxygen});
+	detector.Use_Optimum_Interval({1.0 * keV, 2.0 * keV, 5.0 * keV, 8.0 * keV, 20.0 * keV}, "test_limit.table");
+	// ACT
+	double limit = detector.Upper_Limit(dm, shm, CL);
+	dm.Set_Interaction_Parameter(limit, "Nuclei");
+	// ASSERT
+	ASSERT_GT(limit, 0.0);
+	EXPECT_NEAR(detector.P_Value(dm, shm), 1.0 - CL, 1e-3);
+	dm.Set_Interaction_Parameter(2.0 * limit, "Nuclei");
+	EXPECT_LT(detector.P_Value(dm, shm), 1.0 - CL);
+	// Clean up
+	std::remove("test_limit.table");
+}
@@ -4,6 +4,7 @@
 #include <cmath>
 
 #include "libphysica/Natural_Units.hpp"
+#include "libphysica/Utilities.hpp"
 
 using namespace obscura;
 using namespace libphysica::natural_units;
@@ -20,6 +21,42 @@ TEST(TestTargetElectron, TestvMinimalElectrons)
 	ASSERT_NEAR(vMinimal_Electrons(q, dE, mDM), 0.00767886, tol);
 }
 
+//2. Bilinear interpolation on logarithmically spaced grids
+TEST(TestLogGridInterpolation2D, TestGridPoints)
+{
+	// ARRANGE
+	std::vector<std::vector<double>> table = {{1.0, 2.0, 3.0, 4.0}, {5.0, 6.0, 7.0, 8.0}, {9.0, 10.0, 11.0, 12.0}};
+	Log_Grid_Interpolation_2D interpolation(0.1, 10.0, 1.0, 1000.0, table);
+	// ACT & ASSERT
+	for(unsigned int i = 0; i < table.size(); i++)
+		for(unsigned int j = 0; j < table[i].size(); j++)
+			EXPECT_NEAR(interpolation(interpolation.X_Grid()[i], interpolation.Y_Grid()[j]), table[i][j], 1.0e-12);
+}
+
+TEST(TestLogGridInterpolation2D, TestBilinearFunction)
+{
+	// ARRANGE
+	auto func							   = [](double x, double y) { return 1.0 + 2.0 * x - 3.0 * y + 0.5 * x * y; };
+	std::vector<double> x_grid			   = libphysica::Log_Space(0.1, 10.0, 20);
+	std::vector<double> y_grid			   = libphysica::Log_Space(1.0, 1000.0, 30);
+	std::vector<std::vector<double>> table = std::vector<std::vector<double>>(20, std::vector<double>(30));
+	for(unsigned int i = 0; i < 20; i++)
+		for(unsigned int j = 0; j < 30; j++)
+			table[i][j] = func(x_grid[i], y_grid[j]);
+	Log_Grid_Interpolation_2D interpolation(0.1, 10.0, 1.0, 1000.0, table);
+	std::vector<double> xs = libphysica::Linear_Space(0.1, 10.0, 37);
+	std::vector<double> ys = libphysica::Linear_Space(1.0, 1000.0, 37);
+	// ACT
+	std::vector<double> results = interpolation(xs, ys);
+	// ASSERT
+	for(unsigned int i = 0; i < xs.size(); i++)
+	{
+		EXPECT_NEAR(interpolation(xs[i], ys[i]), func(xs[i], ys[i]), 1.0e-10 * std::fabs(func(xs[i], ys[i])));
+		EXPECT_DOUBLE_EQ(results[i], interpolation(xs[i], ys[i]));
+	}
+}
+
+//3. Bound electrons in isolated atoms
 TEST(TestAtomicElectron, TestConstructor)
 {
 	// ARRANGE
@@ -34,10 +71,10 @@ TEST(TestAtomicElectron, TestConstructor)
 	EXPECT_DOUBLE_EQ(Xe_5p.k_max, k_max);
 	EXPECT_DOUBLE_EQ(Xe_5p.q_min, q_min);
 	EXPECT_DOUBLE_EQ(Xe_5p.q_max, q_max);
-	EXPECT_NEAR(Xe_5p.dlogk, log10(Xe_5p.k_Grid[1] / Xe_5p.k_Grid[0]), 1.0e-10);
-	EXPECT_NEAR(Xe_5p.dlogq, log10(Xe_5p.q_Grid[1] / Xe_5p.q_Grid[0]), 1.0e-10);
-	EXPECT_EQ(Xe_5p.Nk, Xe_5p.k_Grid.size());
-	EXPECT_EQ(Xe_5p.Nq, Xe_5p.q_Grid.size());
+	EXPECT_NEAR(Xe_5p.dlogk, log10(Xe_5p.k_Grid()[1] / Xe_5p.k_Grid()[0]), 1.0e-10);
+	EXPECT_NEAR(Xe_5p.dlogq, log10(Xe_5p.q_Grid()[1] / Xe_5p.q_Grid()[0]), 1.0e-10);
+	EXPECT_EQ(Xe_5p.Nk, Xe_5p.k_Grid().size());
+	EXPECT_EQ(Xe_5p.Nq, Xe_5p.q_Grid().size());
 	EXPECT_EQ(Xe_5p.n, 5);
 	EXPECT_EQ(Xe_5p.l, 1);
 	EXPECT_EQ(Xe_5p.name, "Xe_5p");
@@ -75,6 +112,41 @@ TEST(TestAtomicElectron, TestDipoleApproximation)
 	ASSERT_DOUBLE_EQ(Xe_5p.Ionization_Form_Factor(q, E), q * q / q0 / q0 * F0);
 }
 
+TEST(TestAtomicElectron, TestIonizationFormFactorBatched)
+{
+	// ARRANGE
+	Atom xenon("Xe");
+	const Atomic_Electron& Xe_5p = xenon.Electron(5, 1);
+	std::vector<double> qs		 = {0.5 * keV, keV, 10.0 * keV, 100.0 * keV};
+	std::vector<double> Es		 = {10.0 * eV, 20.0 * eV, 50.0 * eV, 500.0 * eV};
+	// ACT
+	std::vector<double> form_factors = Xe_5p.Ionization_Form_Factor(qs, Es);
+	// ASSERT
+	ASSERT_EQ(form_factors.size(), qs.size());
+	for(unsigned int i = 0; i < qs.size(); i++)
+		EXPECT_DOUBLE_EQ(form_factors[i], Xe_5p.Ionization_Form_Factor(qs[i], Es[i]));
+}
+
+TEST(TestAtomicElectron, TestSharedFormFactorTable)
+{
+	// ARRANGE
+	double q_min = 1.0 * keV;
+	double q_max = 1000.0 * keV;
+	double k_min = 0.1 * keV;
+	double k_max = 100.0 * keV;
+	Atomic_Electron Xe_5p("Xe", 5, 1, 12.4433 * eV, k_min, k_max, q_min, q_max, 0);
+	// ACT
+	Atom xenon_1("Xe");
+	Atom xenon_2("Xe");
+	Atomic_Electron copy = xenon_1.Electron(5, 1);
+	// ASSERT
+	EXPECT_EQ(Xe_5p.form_factor_table, xenon_1.Electron(5, 1).form_factor_table);
+	EXPECT_EQ(Xe_5p.form_factor_table, xenon_2.Electron(5, 1).form_factor_table);
+	EXPECT_EQ(Xe_5p.form_factor_table, copy.form_factor_table);
+	EXPECT_NE(Xe_5p.form_factor_table, xenon_1.Electron(5, 0).form_factor_table);
+	EXPECT_EQ(&Xe_5p.k_Grid(), &copy.k_Grid());
+}
+
 TEST(TestAtomicElectron, TestPrintSummary)
 {
 	// ARRANGE
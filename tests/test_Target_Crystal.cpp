@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include <cmath>
+
 #include "obscura/Target_Crystal.hpp"
 
 #include "libphysica/Natural_Units.hpp"
@@ -30,3 +32,20 @@ TEST(TestTargetCrystal, TestGermanium)
 	ASSERT_EQ(crystal.energy_gap, 0.67 * eV);
 	ASSERT_GT(crystal.Crystal_Form_Factor(q, E), 0.0);
 }
+
+TEST(TestTargetCrystal, TestFormFactorGridPoints)
+{
+	// ARRANGE
+	Crystal crystal("Si");
+	unsigned int qi = 123;
+	unsigned int Ei = 45;
+	double q		= (qi + 1) * crystal.dq;
+	double E		= (Ei + 1) * crystal.dE;
+	// ACT & ASSERT
+	EXPECT_EQ(crystal.Crystal_Form_Factor(q, E), crystal.Crystal_Form_Factor(qi, Ei));
+	EXPECT_EQ(crystal.Crystal_Form_Factor_Row(Ei)[qi], crystal.Crystal_Form_Factor(qi, Ei));
+	double f_mid   = crystal.Crystal_Form_Factor(q + 0.5 * crystal.dq, E);
+	double f_left  = crystal.Crystal_Form_Factor(qi, Ei);
+	double f_right = crystal.Crystal_Form_Factor(qi + 1, Ei);
+	EXPECT_NEAR(f_mid, 0.5 * (f_left + f_right), 1.0e-10 * std::fabs(f_mid));
+}